@@ -0,0 +1,80 @@
+#include <pebble.h>
+#include "complication.h"
+#include "log.h"
+
+static ComplicationSlot *s_slots;
+static uint8_t s_num_slots;
+static ComplicationRefreshProc s_refresh;
+static ComplicationFlushedProc s_flushed;
+
+static bool s_scheduled;
+#if defined(PROFILE)
+static uint8_t s_flushed_sources;
+#endif
+
+void complications_init(ComplicationSlot *slots, uint8_t num_slots, ComplicationRefreshProc refresh,
+                        ComplicationFlushedProc flushed) {
+  s_slots = slots;
+  s_num_slots = num_slots;
+  s_refresh = refresh;
+  s_flushed = flushed;
+  s_scheduled = false;
+}
+
+void complications_deinit(void) {
+  s_slots = NULL;
+  s_num_slots = 0;
+}
+
+static void prv_apply(bool force) {
+  #if defined(PROFILE)
+  char applied[64] = "";
+  int redrawn = 0;
+  #endif
+  for (uint8_t i = 0; i < s_num_slots; i++) {
+    ComplicationSlot *slot = &s_slots[i];
+    if (!force && !slot->pending) {
+      continue;
+    }
+    slot->pending = false;
+    bool dirty = slot->apply(slot, force);
+    #if defined(PROFILE)
+    size_t length = strlen(applied);
+    snprintf(applied + length, sizeof(applied) - length, "%s%s", length ? ", " : "", slot->name);
+    redrawn += dirty;
+    #else
+    (void)dirty;
+    #endif
+  }
+  #if defined(PROFILE)
+  LOG_DEBUG("Complications: sources 0x%x, applied [%s], %d redrawn", s_flushed_sources, applied, redrawn);
+  s_flushed_sources = 0;
+  #endif
+  if (s_flushed) {
+    s_flushed();
+  }
+}
+
+void complications_apply_all(void) {
+  prv_apply(true);
+}
+
+void complications_schedule(uint8_t source, TimeUnits units_changed) {
+  for (uint8_t i = 0; i < s_num_slots; i++) {
+    if ((s_slots[i].sources & source) || (s_slots[i].cadence & units_changed)) {
+      s_slots[i].pending = true;
+    }
+  }
+  s_scheduled = true;
+  #if defined(PROFILE)
+  s_flushed_sources |= source;
+  #endif
+}
+
+void complications_flush(void) {
+  if (!s_scheduled) {
+    return;
+  }
+  s_scheduled = false;
+  prv_apply(s_refresh());
+}
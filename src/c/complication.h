@@ -0,0 +1,60 @@
+#ifndef COMPLICATION_H
+#define COMPLICATION_H
+
+#include <pebble.h>
+
+// Complication slots: the small pieces around the time (battery meter,
+// Bluetooth icon, date, AM/PM, ...). Each slot declares which events and tick
+// units can change it and where it sits; a handler schedules whatever its
+// event feeds and flushes once at the end, so the view model is rebuilt once
+// and every affected slot is applied in a single pass. Layers marked dirty in
+// the same event loop turn share one redraw, so adding a slot never adds a
+// redraw of its own.
+
+typedef enum {
+  ComplicationSourceBattery = 1 << 0,
+  ComplicationSourceConnection = 1 << 1,
+  ComplicationSourceSettings = 1 << 2,
+  ComplicationSourceHealth = 1 << 3
+} ComplicationSource;
+
+typedef struct ComplicationSlot ComplicationSlot;
+
+// Pushes the slot's latest data into its layers and marks whatever changed
+// dirty; returns true if it marked anything. force means every layer property
+// must be set again.
+typedef bool (*ComplicationApplyProc)(ComplicationSlot *slot, bool force);
+
+// Rebuilds whatever the slots read from, once per flush; returns true if every
+// slot must be applied again (a theme change, say)
+typedef bool (*ComplicationRefreshProc)(void);
+
+// Runs at the end of every flush, once the slots are applied
+typedef void (*ComplicationFlushedProc)(void);
+
+struct ComplicationSlot {
+  const char *name;   // for the profile log
+  uint8_t sources;    // ComplicationSource bits that can change it
+  TimeUnits cadence;  // tick units that can change it, 0 for none
+  GRect frame;        // set by the face's layout before the layer is created
+  Layer *layer;
+  ComplicationApplyProc apply;
+  bool pending;
+};
+
+void complications_init(ComplicationSlot *slots, uint8_t num_slots, ComplicationRefreshProc refresh,
+                        ComplicationFlushedProc flushed);
+void complications_deinit(void);
+
+// Sets every slot up from scratch, e.g. right after its layers were created
+void complications_apply_all(void);
+
+// Marks the slots fed by source or by units_changed as pending; nothing is
+// applied until complications_flush
+void complications_schedule(uint8_t source, TimeUnits units_changed);
+
+// Applies every pending slot in one pass; call it last thing in any handler
+// that scheduled
+void complications_flush(void);
+
+#endif
@@ -0,0 +1,165 @@
+#include <pebble.h>
+#include "display_list.h"
+#include "log.h"
+
+static DrawOp *prv_push(DisplayList *list, DrawOpType type) {
+  if (list->num_ops >= DISPLAY_LIST_MAX_OPS) {
+    LOG_ERROR("Display list full, dropping op %d", (int)type);
+    return NULL;
+  }
+  DrawOp *op = &list->ops[list->num_ops++];
+  op->type = type;
+  return op;
+}
+
+void display_list_reset(DisplayList *list) {
+  list->num_ops = 0;
+  list->num_points = 0;
+}
+
+void display_list_set_stroke_color(DisplayList *list, GColor color) {
+  DrawOp *op = prv_push(list, DrawOpStrokeColor);
+  if (op) {
+    op->color = color;
+  }
+}
+
+void display_list_set_fill_color(DisplayList *list, GColor color) {
+  DrawOp *op = prv_push(list, DrawOpFillColor);
+  if (op) {
+    op->color = color;
+  }
+}
+
+void display_list_set_stroke_width(DisplayList *list, uint8_t width) {
+  DrawOp *op = prv_push(list, DrawOpStrokeWidth);
+  if (op) {
+    op->width = width;
+  }
+}
+
+DisplayListPath display_list_add_path(DisplayList *list, const GPoint *points, uint8_t count, GPoint offset) {
+  DisplayListPath path = { .first = list->num_points, .count = 0 };
+  if (list->num_points + count > DISPLAY_LIST_MAX_POINTS) {
+    LOG_ERROR("Display list out of points, dropping path");
+    return path;
+  }
+  // Points are stored already translated, so replay never needs gpath_move_to
+  for (uint8_t i = 0; i < count; i++) {
+    list->points[list->num_points++] = GPoint(points[i].x + offset.x, points[i].y + offset.y);
+  }
+  path.count = count;
+  return path;
+}
+
+static void prv_push_path(DisplayList *list, DrawOpType type, DisplayListPath path) {
+  DrawOp *op = prv_push(list, type);
+  if (op) {
+    op->path = path;
+  }
+}
+
+void display_list_fill_path(DisplayList *list, DisplayListPath path) {
+  prv_push_path(list, DrawOpFillPath, path);
+}
+
+void display_list_draw_path(DisplayList *list, DisplayListPath path) {
+  prv_push_path(list, DrawOpDrawPath, path);
+}
+
+void display_list_draw_path_open(DisplayList *list, DisplayListPath path) {
+  prv_push_path(list, DrawOpDrawPathOpen, path);
+}
+
+static void prv_push_circle(DisplayList *list, DrawOpType type, GPoint center, uint16_t radius) {
+  DrawOp *op = prv_push(list, type);
+  if (op) {
+    op->circle.center = center;
+    op->circle.radius = radius;
+  }
+}
+
+void display_list_fill_circle(DisplayList *list, GPoint center, uint16_t radius) {
+  prv_push_circle(list, DrawOpFillCircle, center, radius);
+}
+
+void display_list_draw_circle(DisplayList *list, GPoint center, uint16_t radius) {
+  prv_push_circle(list, DrawOpDrawCircle, center, radius);
+}
+
+void display_list_fill_radial(DisplayList *list, GRect rect, uint16_t inset, int32_t angle_start, int32_t angle_end) {
+  DrawOp *op = prv_push(list, DrawOpFillRadial);
+  if (op) {
+    op->radial.rect = rect;
+    op->radial.inset = inset;
+    op->radial.angle_start = angle_start;
+    op->radial.angle_end = angle_end;
+  }
+}
+
+// A GPath on the stack avoids the heap allocation gpath_create would make every frame
+static GPath prv_path(DisplayList *list, const DrawOp *op) {
+  return (GPath) { .num_points = op->path.count, .points = &list->points[op->path.first] };
+}
+
+void display_list_replay(DisplayList *list, GContext *ctx) {
+  #if defined(PROFILE)
+  time_t start_s;
+  uint16_t start_ms = time_ms(&start_s, NULL);
+  #endif
+
+  for (uint8_t i = 0; i < list->num_ops; i++) {
+    const DrawOp *op = &list->ops[i];
+
+    switch (op->type) {
+      case DrawOpStrokeColor:
+        graphics_context_set_stroke_color(ctx, op->color);
+        break;
+      case DrawOpFillColor:
+        graphics_context_set_fill_color(ctx, op->color);
+        break;
+      case DrawOpStrokeWidth:
+        graphics_context_set_stroke_width(ctx, op->width);
+        break;
+      case DrawOpFillPath: {
+        GPath path = prv_path(list, op);
+        gpath_draw_filled(ctx, &path);
+        break;
+      }
+      case DrawOpDrawPath: {
+        GPath path = prv_path(list, op);
+        gpath_draw_outline(ctx, &path);
+        break;
+      }
+      case DrawOpDrawPathOpen: {
+        GPath path = prv_path(list, op);
+        gpath_draw_outline_open(ctx, &path);
+        break;
+      }
+      case DrawOpFillCircle:
+        graphics_fill_circle(ctx, op->circle.center, op->circle.radius);
+        break;
+      case DrawOpDrawCircle:
+        graphics_draw_circle(ctx, op->circle.center, op->circle.radius);
+        break;
+      case DrawOpFillRadial:
+        graphics_fill_radial(ctx, op->radial.rect, GOvalScaleModeFitCircle, op->radial.inset,
+                             op->radial.angle_start, op->radial.angle_end);
+        break;
+    }
+  }
+
+  #if defined(PROFILE)
+  time_t end_s;
+  uint16_t end_ms = time_ms(&end_s, NULL);
+  list->replay_ms = (end_s - start_s) * 1000 + end_ms - start_ms;
+  #endif
+}
+
+size_t display_list_get_size(const DisplayList *list) {
+  return list->num_ops * sizeof(DrawOp) + list->num_points * sizeof(GPoint);
+}
+
+uint16_t display_list_get_replay_ms(const DisplayList *list) {
+  return list->replay_ms;
+}
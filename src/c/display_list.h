@@ -0,0 +1,78 @@
+#ifndef DISPLAY_LIST_H
+#define DISPLAY_LIST_H
+
+#include <pebble.h>
+
+// A retained list of drawing operations. Recording happens when the picture
+// changes (a new minute, a new theme); replaying it in an update proc just
+// issues the stored graphics calls without recomputing any geometry.
+
+#define DISPLAY_LIST_MAX_OPS 24
+#define DISPLAY_LIST_MAX_POINTS 24
+
+typedef enum {
+  DrawOpStrokeColor,
+  DrawOpFillColor,
+  DrawOpStrokeWidth,
+  DrawOpFillPath,
+  DrawOpDrawPath,
+  DrawOpDrawPathOpen,
+  DrawOpFillCircle,
+  DrawOpDrawCircle,
+  DrawOpFillRadial
+} DrawOpType;
+
+// A run of points inside the list's point pool
+typedef struct {
+  uint8_t first;
+  uint8_t count;
+} DisplayListPath;
+
+typedef struct {
+  uint8_t type;
+  union {
+    GColor color;
+    uint8_t width;
+    DisplayListPath path;
+    struct {
+      GPoint center;
+      uint16_t radius;
+    } circle;
+    struct {
+      GRect rect;
+      uint16_t inset;
+      int32_t angle_start;
+      int32_t angle_end;
+    } radial;
+  };
+} DrawOp;
+
+typedef struct {
+  DrawOp ops[DISPLAY_LIST_MAX_OPS];
+  GPoint points[DISPLAY_LIST_MAX_POINTS];
+  uint8_t num_ops;
+  uint8_t num_points;
+  uint16_t replay_ms; // only measured when built with PROFILE
+} DisplayList;
+
+// Recording
+void display_list_reset(DisplayList *list);
+void display_list_set_stroke_color(DisplayList *list, GColor color);
+void display_list_set_fill_color(DisplayList *list, GColor color);
+void display_list_set_stroke_width(DisplayList *list, uint8_t width);
+DisplayListPath display_list_add_path(DisplayList *list, const GPoint *points, uint8_t count, GPoint offset);
+void display_list_fill_path(DisplayList *list, DisplayListPath path);
+void display_list_draw_path(DisplayList *list, DisplayListPath path);
+void display_list_draw_path_open(DisplayList *list, DisplayListPath path);
+void display_list_fill_circle(DisplayList *list, GPoint center, uint16_t radius);
+void display_list_draw_circle(DisplayList *list, GPoint center, uint16_t radius);
+void display_list_fill_radial(DisplayList *list, GRect rect, uint16_t inset, int32_t angle_start, int32_t angle_end);
+
+// Replay
+void display_list_replay(DisplayList *list, GContext *ctx);
+
+// Benchmarking
+size_t display_list_get_size(const DisplayList *list);
+uint16_t display_list_get_replay_ms(const DisplayList *list);
+
+#endif
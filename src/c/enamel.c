@@ -79,6 +79,48 @@ const char* enamel_get_BluetoothConnect(){
 }
 // -----------------------------------------------------
 
+// -----------------------------------------------------
+// Getter for 'SleepQuiet'
+const char* enamel_get_SleepQuiet(){
+	Tuple* tuple = dict_find(&s_dict, 2548207201);
+	return tuple ? tuple->value->cstring : "yes";
+}
+// -----------------------------------------------------
+
+// -----------------------------------------------------
+// Getter for 'QuietWindow'
+const char* enamel_get_QuietWindow(){
+	Tuple* tuple = dict_find(&s_dict, 939959751);
+	return tuple ? tuple->value->cstring : "no";
+}
+// -----------------------------------------------------
+
+// -----------------------------------------------------
+// Getter for 'QuietStart'
+int32_t enamel_get_QuietStart(){
+	Tuple* tuple = dict_find(&s_dict, 3542195462);
+		
+	return tuple ? tuple->value->int32 : 23;
+}
+// -----------------------------------------------------
+
+// -----------------------------------------------------
+// Getter for 'QuietEnd'
+int32_t enamel_get_QuietEnd(){
+	Tuple* tuple = dict_find(&s_dict, 4276736583);
+		
+	return tuple ? tuple->value->int32 : 7;
+}
+// -----------------------------------------------------
+
+// -----------------------------------------------------
+// Getter for 'Diagnostics'
+const char* enamel_get_Diagnostics(){
+	Tuple* tuple = dict_find(&s_dict, 678202839);
+	return tuple ? tuple->value->cstring : "no";
+}
+// -----------------------------------------------------
+
 
 static uint16_t prv_get_inbound_size() {
 	return 1
@@ -88,6 +130,11 @@ static uint16_t prv_get_inbound_size() {
 		+ 7 + 13
 		+ 7 + 8
 		+ 7 + 8
+		+ 7 + 4
+		+ 7 + 4
+		+ 7 + 4
+		+ 7 + 4
+		+ 7 + 4
 ;
 }
 
@@ -98,6 +145,11 @@ static uint32_t prv_map_messagekey(const uint32_t key){
 	if( key == MESSAGE_KEY_BluetoothStatus) return 1404430411;
 	if( key == MESSAGE_KEY_BluetoothDisconnect) return 2950883263;
 	if( key == MESSAGE_KEY_BluetoothConnect) return 1243542880;
+	if( key == MESSAGE_KEY_SleepQuiet) return 2548207201;
+	if( key == MESSAGE_KEY_QuietWindow) return 939959751;
+	if( key == MESSAGE_KEY_QuietStart) return 3542195462;
+	if( key == MESSAGE_KEY_QuietEnd) return 4276736583;
+	if( key == MESSAGE_KEY_Diagnostics) return 678202839;
 	return 0;
 }
 
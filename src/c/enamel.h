@@ -39,6 +39,33 @@ const char* enamel_get_BluetoothDisconnect();
 const char* enamel_get_BluetoothConnect();
 // -----------------------------------------------------
 
+// -----------------------------------------------------
+// Getter for 'SleepQuiet'
+const char* enamel_get_SleepQuiet();
+// -----------------------------------------------------
+
+// -----------------------------------------------------
+// Getter for 'QuietWindow'
+const char* enamel_get_QuietWindow();
+// -----------------------------------------------------
+
+// -----------------------------------------------------
+// Getter for 'QuietStart'
+#define QUIETSTART_PRECISION 1
+int32_t enamel_get_QuietStart();
+// -----------------------------------------------------
+
+// -----------------------------------------------------
+// Getter for 'QuietEnd'
+#define QUIETEND_PRECISION 1
+int32_t enamel_get_QuietEnd();
+// -----------------------------------------------------
+
+// -----------------------------------------------------
+// Getter for 'Diagnostics'
+const char* enamel_get_Diagnostics();
+// -----------------------------------------------------
+
 void enamel_init();
 
 void enamel_deinit();
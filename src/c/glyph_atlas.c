@@ -0,0 +1,215 @@
+#include <pebble.h>
+#include "glyph_atlas.h"
+#include "log.h"
+
+#if defined(GLYPH_ATLAS)
+
+#define GLYPH_ATLAS_FORMAT PBL_IF_COLOR_ELSE(GBitmapFormat8Bit, GBitmapFormat1Bit)
+
+static bool prv_is_digit(const char *glyph) {
+  return glyph[0] >= '0' && glyph[0] <= '9' && glyph[1] == '\0';
+}
+
+void glyph_atlas_init(GlyphAtlas *atlas, GFont font, const char *const *glyphs, uint8_t num_glyphs) {
+  *atlas = (GlyphAtlas) {
+    .font = font,
+    .glyphs = glyphs,
+    .num_glyphs = num_glyphs < GLYPH_ATLAS_MAX_GLYPHS ? num_glyphs : GLYPH_ATLAS_MAX_GLYPHS
+  };
+}
+
+void glyph_atlas_destroy(GlyphAtlas *atlas) {
+  for (uint8_t i = 0; i < atlas->num_glyphs; i++) {
+    if (atlas->cells[i]) {
+      gbitmap_destroy(atlas->cells[i]);
+      atlas->cells[i] = NULL;
+    }
+  }
+  if (atlas->bitmap) {
+    gbitmap_destroy(atlas->bitmap);
+    atlas->bitmap = NULL;
+  }
+  atlas->ready = false;
+}
+
+// Measures every glyph and allocates the bitmap and its cells; only needed once,
+// since a theme change redraws the same glyphs in another color
+static bool prv_allocate(GlyphAtlas *atlas) {
+  const GRect layout_box = GRect(0, 0, 200, 200);
+  int16_t digit_width = 0;
+  GSize cell_size = GSizeZero;
+  for (uint8_t i = 0; i < atlas->num_glyphs; i++) {
+    GSize size = graphics_text_layout_get_content_size(atlas->glyphs[i], atlas->font, layout_box,
+                                                       GTextOverflowModeFill, GTextAlignmentLeft);
+    atlas->widths[i] = size.w;
+    if (prv_is_digit(atlas->glyphs[i]) && size.w > digit_width) {
+      digit_width = size.w;
+    }
+    cell_size.w = size.w > cell_size.w ? size.w : cell_size.w;
+    cell_size.h = size.h > cell_size.h ? size.h : cell_size.h;
+  }
+  for (uint8_t i = 0; i < atlas->num_glyphs; i++) {
+    if (prv_is_digit(atlas->glyphs[i])) {
+      atlas->widths[i] = digit_width;
+    }
+  }
+  atlas->cell_size = cell_size;
+
+  atlas->bitmap = gbitmap_create_blank(GSize(cell_size.w, cell_size.h * atlas->num_glyphs), GLYPH_ATLAS_FORMAT);
+  if (!atlas->bitmap) {
+    return false;
+  }
+  for (uint8_t i = 0; i < atlas->num_glyphs; i++) {
+    atlas->cells[i] = gbitmap_create_as_sub_bitmap(atlas->bitmap,
+                                                   GRect(0, i * cell_size.h, atlas->widths[i], cell_size.h));
+    if (!atlas->cells[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+#if defined(PBL_COLOR)
+// Text is anti-aliased against the flat key, so how far a pixel moved from
+// key_color towards text_color is the glyph's coverage there. Storing that as
+// the alpha of a text_color pixel lets the edges blend over whatever the cell
+// is later drawn on, instead of keeping a fringe of the key color.
+static uint8_t prv_coverage_pixel(GColor pixel, GColor text_color, GColor key_color) {
+  // Measure along the channel where text and key differ most
+  int span = text_color.r - key_color.r, moved = pixel.r - key_color.r;
+  if (abs(text_color.g - key_color.g) > abs(span)) {
+    span = text_color.g - key_color.g;
+    moved = pixel.g - key_color.g;
+  }
+  if (abs(text_color.b - key_color.b) > abs(span)) {
+    span = text_color.b - key_color.b;
+    moved = pixel.b - key_color.b;
+  }
+  if (span < 0) {
+    span = -span;
+    moved = -moved;
+  }
+  int alpha = span ? (6 * moved + span) / (2 * span) : 0;
+  if (alpha <= 0) {
+    return GColorClear.argb;
+  }
+  GColor out = text_color;
+  out.a = alpha > 3 ? 3 : alpha;
+  return out.argb;
+}
+#else
+// 1-bit text has no anti-aliasing, so every pixel is either text or key
+static bool prv_get_pixel(const GBitmapDataRowInfo *row, int x) {
+  return (row->data[x / 8] >> (x % 8)) & 1;
+}
+
+static void prv_set_pixel(const GBitmapDataRowInfo *row, int x, bool value) {
+  if (value) {
+    row->data[x / 8] |= 1 << (x % 8);
+  } else {
+    row->data[x / 8] &= ~(1 << (x % 8));
+  }
+}
+#endif
+
+// Copies one glyph from the frame buffer into its cell, turning key_color transparent
+static bool prv_copy_cell(GlyphAtlas *atlas, GContext *ctx, uint8_t index, GPoint scratch, GColor text_color,
+                          GColor key_color) {
+  GBitmap *frame_buffer = graphics_capture_frame_buffer(ctx);
+  if (!frame_buffer) {
+    return false;
+  }
+  for (int16_t y = 0; y < atlas->cell_size.h; y++) {
+    GBitmapDataRowInfo src = gbitmap_get_data_row_info(frame_buffer, scratch.y + y);
+    GBitmapDataRowInfo dst = gbitmap_get_data_row_info(atlas->bitmap, index * atlas->cell_size.h + y);
+    for (int16_t x = 0; x < atlas->widths[index]; x++) {
+      int src_x = scratch.x + x;
+      bool inside = src_x >= src.min_x && src_x <= src.max_x;
+      #if defined(PBL_COLOR)
+      dst.data[x] = inside ? prv_coverage_pixel((GColor) { .argb = src.data[src_x] }, text_color, key_color)
+                           : GColorClear.argb;
+      #else
+      prv_set_pixel(&dst, x, inside ? prv_get_pixel(&src, src_x) : gcolor_equal(key_color, GColorWhite));
+      #endif
+    }
+  }
+  graphics_release_frame_buffer(ctx, frame_buffer);
+  return true;
+}
+
+bool glyph_atlas_build(GlyphAtlas *atlas, GContext *ctx, GPoint scratch, GColor text_color, GColor key_color) {
+  atlas->ready = false;
+  if (!atlas->bitmap && !prv_allocate(atlas)) {
+    LOG_ERROR("Glyph atlas: out of memory");
+    glyph_atlas_destroy(atlas);
+    return false;
+  }
+
+  graphics_context_set_text_color(ctx, text_color);
+  graphics_context_set_fill_color(ctx, key_color);
+  for (uint8_t i = 0; i < atlas->num_glyphs; i++) {
+    GRect cell = GRect(scratch.x, scratch.y, atlas->widths[i], atlas->cell_size.h);
+    graphics_fill_rect(ctx, cell, 0, GCornerNone);
+    // Centered, so a narrow digit sits in the middle of its fixed-width cell
+    graphics_draw_text(ctx, atlas->glyphs[i], atlas->font, cell, GTextOverflowModeFill, GTextAlignmentCenter, NULL);
+    if (!prv_copy_cell(atlas, ctx, i, scratch, text_color, key_color)) {
+      return false;
+    }
+  }
+  graphics_fill_rect(ctx, GRect(scratch.x, scratch.y, atlas->cell_size.w, atlas->cell_size.h), 0, GCornerNone);
+
+  // Color cells carry their coverage as alpha for GCompOpSet to blend; without
+  // alpha, dark glyphs on a white key are ANDed in and light glyphs on a black
+  // key are ORed in
+  atlas->compositing = PBL_IF_COLOR_ELSE(GCompOpSet, gcolor_equal(key_color, GColorWhite) ? GCompOpAnd : GCompOpOr);
+  atlas->ready = true;
+  return true;
+}
+
+static int prv_find_glyph(const GlyphAtlas *atlas, const char *text, size_t *length) {
+  for (uint8_t i = 0; i < atlas->num_glyphs; i++) {
+    size_t glyph_length = strlen(atlas->glyphs[i]);
+    if (strncmp(text, atlas->glyphs[i], glyph_length) == 0) {
+      *length = glyph_length;
+      return i;
+    }
+  }
+  *length = 1;
+  return -1;
+}
+
+void glyph_atlas_draw(const GlyphAtlas *atlas, GContext *ctx, const char *text, GRect box, GTextAlignment alignment) {
+  int16_t width = 0;
+  size_t length;
+  for (const char *c = text; *c; c += length) {
+    int glyph = prv_find_glyph(atlas, c, &length);
+    width += glyph >= 0 ? atlas->widths[glyph] : 0;
+  }
+
+  int16_t x = box.origin.x;
+  if (alignment == GTextAlignmentRight) {
+    x += box.size.w - width;
+  } else if (alignment == GTextAlignmentCenter) {
+    x += (box.size.w - width) / 2;
+  }
+
+  graphics_context_set_compositing_mode(ctx, atlas->compositing);
+  for (const char *c = text; *c; c += length) {
+    int glyph = prv_find_glyph(atlas, c, &length);
+    if (glyph >= 0) {
+      graphics_draw_bitmap_in_rect(ctx, atlas->cells[glyph], GRect(x, box.origin.y, atlas->widths[glyph], atlas->cell_size.h));
+      x += atlas->widths[glyph];
+    }
+  }
+  graphics_context_set_compositing_mode(ctx, GCompOpAssign);
+}
+
+size_t glyph_atlas_get_size(const GlyphAtlas *atlas) {
+  if (!atlas->bitmap) {
+    return 0;
+  }
+  GRect bounds = gbitmap_get_bounds(atlas->bitmap);
+  return gbitmap_get_bytes_per_row(atlas->bitmap) * bounds.size.h;
+}
+
+#endif
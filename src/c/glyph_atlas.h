@@ -0,0 +1,43 @@
+#ifndef GLYPH_ATLAS_H
+#define GLYPH_ATLAS_H
+
+#include <pebble.h>
+
+// Glyphs rasterized once into a bitmap, then drawn with plain blits instead of
+// laying out and rasterizing text every frame. There is no offscreen context,
+// so building draws each glyph into the frame buffer and copies it out; do it
+// from an update proc that runs before anything opaque covers that area.
+// Digits all get the width of the widest one, so the time never shifts as it
+// changes.
+
+#define GLYPH_ATLAS_MAX_GLYPHS 12
+
+typedef struct {
+  GFont font;
+  const char *const *glyphs;  // each entry is drawn as one cell, e.g. "7", ":" or "pm"
+  uint8_t num_glyphs;
+  GBitmap *bitmap;            // cells stacked top to bottom
+  GBitmap *cells[GLYPH_ATLAS_MAX_GLYPHS];
+  GSize cell_size;            // width of the widest cell, height of every cell
+  int16_t widths[GLYPH_ATLAS_MAX_GLYPHS];
+  GCompOp compositing;
+  bool ready;
+} GlyphAtlas;
+
+void glyph_atlas_init(GlyphAtlas *atlas, GFont font, const char *const *glyphs, uint8_t num_glyphs);
+void glyph_atlas_destroy(GlyphAtlas *atlas);
+
+// Rasterizes every glyph in text_color, using the frame buffer at scratch as
+// working space, over key_color, which must differ from text_color. On color
+// displays each pixel keeps its anti-aliasing coverage as alpha, so the key
+// leaves no fringe; on black and white the key simply becomes transparent.
+// Returns false (and leaves the atlas not ready) on failure.
+bool glyph_atlas_build(GlyphAtlas *atlas, GContext *ctx, GPoint scratch, GColor text_color, GColor key_color);
+
+// Lays text out in box like a TextLayer with the same alignment would. Any
+// character the atlas does not have is skipped.
+void glyph_atlas_draw(const GlyphAtlas *atlas, GContext *ctx, const char *text, GRect box, GTextAlignment alignment);
+
+size_t glyph_atlas_get_size(const GlyphAtlas *atlas);
+
+#endif
@@ -0,0 +1,51 @@
+#ifndef LOG_H
+#define LOG_H
+
+#include <pebble.h>
+
+// Compile-time log level. Every APP_LOG formats a string and sends it over
+// Bluetooth, so release builds compile them all away; pick a level with
+// pebble build -- --log-level=<level>. Profile builds keep everything.
+
+#define LOG_LEVEL_NONE 0
+#define LOG_LEVEL_ERROR 1
+#define LOG_LEVEL_WARNING 2
+#define LOG_LEVEL_INFO 3
+#define LOG_LEVEL_DEBUG 4
+
+#if !defined(LOG_LEVEL)
+#if defined(PROFILE)
+#define LOG_LEVEL LOG_LEVEL_DEBUG
+#else
+#define LOG_LEVEL LOG_LEVEL_NONE
+#endif
+#endif
+
+// Stripped calls still type-check their arguments but never evaluate them
+#define LOG_DISCARD(fmt, ...) do { if (0) { APP_LOG(APP_LOG_LEVEL_DEBUG, fmt, ##__VA_ARGS__); } } while (0)
+
+#if LOG_LEVEL >= LOG_LEVEL_ERROR
+#define LOG_ERROR(fmt, ...) APP_LOG(APP_LOG_LEVEL_ERROR, fmt, ##__VA_ARGS__)
+#else
+#define LOG_ERROR(fmt, ...) LOG_DISCARD(fmt, ##__VA_ARGS__)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_WARNING
+#define LOG_WARNING(fmt, ...) APP_LOG(APP_LOG_LEVEL_WARNING, fmt, ##__VA_ARGS__)
+#else
+#define LOG_WARNING(fmt, ...) LOG_DISCARD(fmt, ##__VA_ARGS__)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_INFO
+#define LOG_INFO(fmt, ...) APP_LOG(APP_LOG_LEVEL_INFO, fmt, ##__VA_ARGS__)
+#else
+#define LOG_INFO(fmt, ...) LOG_DISCARD(fmt, ##__VA_ARGS__)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+#define LOG_DEBUG(fmt, ...) APP_LOG(APP_LOG_LEVEL_DEBUG, fmt, ##__VA_ARGS__)
+#else
+#define LOG_DEBUG(fmt, ...) LOG_DISCARD(fmt, ##__VA_ARGS__)
+#endif
+
+#endif
@@ -1,20 +1,46 @@
 #include <pebble.h>
 #include <pdc-transform/pdc-transform.h>
 #include "enamel.h"
+#include "display_list.h"
+#include "complication.h"
+#include "log.h"
+#include "trace.h"
+#include "glyph_atlas.h"
 #include <pebble-events/pebble-events.h>
 
 static Window *s_main_window;
+#if !defined(GLYPH_ATLAS)
 static TextLayer *s_time_layer;
+#endif
 static TextLayer *s_day_layer;
 static TextLayer *s_date_layer;
+#if !defined(GLYPH_ATLAS)
 static TextLayer *s_pm_layer;
+#endif
 static GFont s_time_font;
 static GFont s_date_font;
 
 static Layer *s_canvas_layer;
-static GPath *hour_hand;
-static GPath *inner_sun;
-static GPath *outer_sun;
+
+#if defined(GLYPH_ATLAS)
+// The time and AM/PM are blitted from glyphs rasterized once per theme, in
+// place of the time and AM/PM TextLayers
+static const char *const TIME_GLYPHS[] = { "0", "1", "2", "3", "4", "5", "6", "7", "8", "9", ":" };
+static const char *const PM_GLYPHS[] = { "am", "pm" };
+static GlyphAtlas s_time_atlas;
+static GlyphAtlas s_pm_atlas;
+static Layer *s_glyph_atlas_layer;
+static Layer *s_time_glyph_layer;
+static Layer *s_pm_glyph_layer;
+static int s_atlas_daytime = -1; // the theme the atlases were last built for
+#endif
+
+// Empty layers drawn first and last, so the trace sees each redraw start and
+// end. They only exist while Diagnostics is on, or in profile builds.
+static Layer *s_redraw_start_layer;
+static Layer *s_redraw_end_layer;
+static bool s_diagnostics;
+static DisplayList s_canvas_list;
 
 // These are for the battery level
 static int s_battery_level;
@@ -24,10 +50,6 @@ static BitmapLayer *s_battery_icon_layer;
 static GBitmap *s_battery_icon, *s_battery_icon_dark;
 static GBitmap *s_battery_icon_plus, *s_battery_icon_plus_dark;
 
-static bool daytime;
-static GColor foreground_color;
-static GColor background_color;
-
 // For the bitmap background
 
 static BitmapLayer *s_background_layer;
@@ -38,44 +60,16 @@ static GBitmap *s_background_bitmap_night;
 
 static GDrawCommandImage *s_command_image;
 
-#if PBL_DISPLAY_WIDTH == 200
-static const GPathInfo SUN_INNER_RAYS_INFO = {
-  .num_points = 8,
-  .points = (GPoint[]) {{7,7}, {21,14}, {35,7}, {28, 21}, {35, 35}, {21,28}, {7, 35}, {14,21}}
-};
-static const GPathInfo SUN_OUTER_RAYS_INFO = {
-  .num_points = 8,
-  .points = (GPoint[]) {{21, 0}, {28, 14}, {42, 21}, {28, 28}, {21, 42}, {14, 28}, {0, 21}, {14,14}}
-};
-static int sun_offset = 21;
-static int small_sun_radius = 10;
-
-static int moon_outer_radius = 19;
-static int moon_inner_radius = 11;
-
-#else
-static const GPathInfo SUN_INNER_RAYS_INFO = {
-  .num_points = 8,
-  .points = (GPoint[]) {{5,5}, {15,10}, {25,5}, {20, 15}, {25, 25}, {15,20}, {5, 25}, {10,15}}
-};
-static const GPathInfo SUN_OUTER_RAYS_INFO = {
-  .num_points = 8,
-  .points = (GPoint[]) {{15, 0}, {20, 10}, {30, 15}, {20, 20}, {15, 30}, {10, 20}, {0, 15}, {10,10}}
-};
-static int sun_offset = 15;
-static int small_sun_radius = 7;
-
-static int moon_outer_radius = 14;
-static int moon_inner_radius = 8;
-#endif
+// Sun, moon and dial geometry for this platform's display, generated at build time
+#include "geometry.auto.h"
 
 // Bluetooth
 
-static Layer *s_bt_layer;
 static BitmapLayer *s_bt_icon_layer;
 static GBitmap *s_bt_icon_bitmap, *s_bt_icon_bitmap_dark;
 static GBitmap *s_bt_icon_on_bitmap, *s_bt_icon_on_bitmap_dark;
 static GBitmap *s_bt_icon_off_bitmap, *s_bt_icon_off_bitmap_dark;
+static bool s_bt_connected;
 
 static const VibePattern SIGNAL_LOST = {
   .durations = (uint32_t[]) {200, 300, 500},
@@ -93,100 +87,165 @@ static int end_hour;
 
 static EventHandle s_boundary_handle;
 
-// Update daytime from anywhere
+// Quiet mode: hourly updates and no vibrations while the wearer is asleep
+static bool s_asleep;
 
-static void check_daytime() {
-  time_t start_stamp = clock_to_timestamp(TODAY, start_hour, 0);
-  time_t end_stamp = clock_to_timestamp(TODAY, end_hour, 0);
-  
-  daytime = end_stamp < start_stamp; // Check if this is correct; needs to be more elegant to swap colors right at 7:00, not 7:01
-  foreground_color = daytime ? GColorBlack : GColorWhite;
-  background_color = daytime ? GColorWhite : GColorBlack;
-  bitmap_layer_set_bitmap(s_background_layer, daytime ? s_background_bitmap_day : s_background_bitmap_night);
-  
-  text_layer_set_text_color(s_time_layer, foreground_color);
-  text_layer_set_text_color(s_day_layer, foreground_color);
-  text_layer_set_text_color(s_date_layer, foreground_color);
-  text_layer_set_text_color(s_pm_layer, foreground_color);
-}
+// Which Bluetooth icon to show; the bitmap itself also depends on the theme
+typedef enum {
+  BtIconPlain,
+  BtIconOn,
+  BtIconOff
+} BtIcon;
+
+// Everything the layers display, derived from the raw inputs above. It is only
+// rebuilt from event handlers; update procs read it and never change anything.
+// It holds no resource pointers, so it can be built before the window loads.
+typedef struct {
+  time_t minute;
+  int start_hour;
+  int end_hour;
+  bool asleep;
+
+  bool daytime;
+  GColor foreground_color;
+  GColor background_color;
+
+  char time_text[8];
+  char day_text[16];
+  char date_text[16];
+  char pm_text[8];
+
+  bool battery_shown;
+  bool battery_charging;
+  int battery_level;
+  GColor battery_color;
 
+  bool bt_shown;
+  BtIcon bt_icon;
+} ViewModel;
 
-static void update_time() {
-  check_daytime();
-  // Get a tm structure
-  time_t temp = time(NULL);
-  struct tm *tick_time = localtime(&temp);
+static ViewModel s_view;
 
-  // Write the current hours and minutes into a buffer
-  static char s_buffer[16];
-  strftime(s_buffer, sizeof(s_buffer), clock_is_24h_style() ?
-                                          "%H:%M" : "%I:%M", tick_time);
+#if defined(PROFILE)
+static int s_layers_invalidated;
+static int s_frames_drawn;
+// Launch-to-first-frame latency, measured from the start of init
+static int64_t s_launch_ms;
+static bool s_first_frame_logged;
+// Whole-frame time, from the redraw start marker to the end one
+static int64_t s_frame_started_ms;
+
+static int64_t profile_now_ms() {
+  time_t seconds;
+  uint16_t ms;
+  time_ms(&seconds, &ms);
+  return (int64_t)seconds * 1000 + ms;
+}
+#endif
+
+static void build_time_text(ViewModel *vm, struct tm *tick_time) {
+  // Write the current hours and minutes into a buffer; just the hour while
+  // asleep, since the face only wakes once an hour then
+  if (vm->asleep) {
+    strftime(vm->time_text, sizeof(vm->time_text), clock_is_24h_style() ? "%H" : "%I", tick_time);
+  } else {
+    strftime(vm->time_text, sizeof(vm->time_text), clock_is_24h_style() ?
+                                            "%H:%M" : "%I:%M", tick_time);
+  }
   
-  if('0' == s_buffer[0]) {
-    memmove(s_buffer, &s_buffer[1], sizeof(s_buffer)-1);
+  if('0' == vm->time_text[0]) {
+    memmove(vm->time_text, &vm->time_text[1], sizeof(vm->time_text)-1);
   } // thanks morris https://forums.pebble.com/t/remove-padding-from-12-hour-time/15700
   
   // Write the current day and month into a buffer
-  static char dd_buffer[16];
-  strftime(dd_buffer, sizeof(dd_buffer), PBL_IF_ROUND_ELSE("%a", "%A"), tick_time);
+  strftime(vm->day_text, sizeof(vm->day_text), PBL_IF_ROUND_ELSE("%a", "%A"), tick_time);
   
-  static char m_buffer[16];
-  strftime(m_buffer, sizeof(m_buffer), "%b ", tick_time);
+  strftime(vm->date_text, sizeof(vm->date_text), "%b ", tick_time);
 
   // And also the numbered date
-  static char date_buffer[16];
+  char date_buffer[4];
   strftime(date_buffer, sizeof(date_buffer), "%d", tick_time);
 
   if('0' == date_buffer[0]) {
     memmove(date_buffer, &date_buffer[1], sizeof(date_buffer)-1);
   } // thanks morris https://forums.pebble.com/t/remove-padding-from-12-hour-time/15700
   
-  strncat(m_buffer, date_buffer, 2);
+  strncat(vm->date_text, date_buffer, 2);
+
+  // The night rendering leaves out the day and date
+  if (vm->asleep) {
+    vm->day_text[0] = '\0';
+    vm->date_text[0] = '\0';
+  }
   
   // Write AM/PM into a buffer
-  static char pm_buffer[8];
-  strftime(pm_buffer, sizeof(pm_buffer), "%P", tick_time);
-  
-  // Display this time on their TextLayers
-  text_layer_set_text(s_time_layer, s_buffer);
-  text_layer_set_text(s_day_layer, dd_buffer);
-  text_layer_set_text(s_date_layer, m_buffer);
-  if (!clock_is_24h_style()) {
-    text_layer_set_text(s_pm_layer, pm_buffer);
+  if (clock_is_24h_style()) {
+    vm->pm_text[0] = '\0';
+  } else {
+    strftime(vm->pm_text, sizeof(vm->pm_text), "%P", tick_time);
   }
 }
 
-static void battery_callback(BatteryChargeState state) {
-  // Record the new battery level
-  s_battery_level = state.charge_percent;
-  s_battery_charging = state.is_charging;
-  // Update meter
-  layer_mark_dirty(s_battery_layer);
+static void build_view_model(ViewModel *vm) {
+  time_t now = time(NULL);
+  vm->minute = now - now % 60;
+  vm->start_hour = start_hour;
+  vm->end_hour = end_hour;
+  vm->asleep = s_asleep;
 
-}
+  time_t start_stamp = clock_to_timestamp(TODAY, start_hour, 0);
+  time_t end_stamp = clock_to_timestamp(TODAY, end_hour, 0);
+  
+  vm->daytime = end_stamp < start_stamp; // Check if this is correct; needs to be more elegant to swap colors right at 7:00, not 7:01
+  vm->foreground_color = vm->daytime ? GColorBlack : GColorWhite;
+  vm->background_color = vm->daytime ? GColorWhite : GColorBlack;
 
-static void tick_handler(struct tm *tick_time, TimeUnits units_changed) {
-  update_time();
-  layer_mark_dirty(s_canvas_layer);
+  build_time_text(vm, localtime(&now));
+
+  // Read each setting once per rebuild
+  const char *battery_status = enamel_get_BatteryStatus();
+  const char *bluetooth_status = enamel_get_BluetoothStatus();
+
+  vm->battery_shown = strcmp(battery_status, "yes") == 0 || (strcmp(battery_status, "low") == 0 && (s_battery_level < 30 || s_battery_charging));
+  vm->battery_charging = s_battery_charging;
+  vm->battery_level = s_battery_level;
+  #if defined(PBL_COLOR)
+  if (s_battery_level > 30) {
+    vm->battery_color = GColorKellyGreen;
+  } else if (s_battery_level > 10) {
+    vm->battery_color = GColorChromeYellow;
+  } else {
+    vm->battery_color = GColorDarkCandyAppleRed;
+  }
+  #else
+    vm->battery_color = vm->background_color;
+  #endif
+
+  if (s_bt_connected) {
+    vm->bt_icon = BtIconOn;
+    vm->bt_shown = strcmp(bluetooth_status, "yes") == 0;
+  } else if (strcmp(bluetooth_status, "yes") == 0) {
+    vm->bt_icon = BtIconOff;
+    vm->bt_shown = true;
+  } else {
+    vm->bt_icon = BtIconPlain;
+    vm->bt_shown = strcmp(bluetooth_status, "disconnected") == 0;
+  }
+
+  if (vm->asleep) {
+    vm->battery_shown = false;
+    vm->bt_shown = false;
+  }
 }
 
-static void canvas_update_proc(Layer *layer, GContext *ctx) {
+// Rebuild the canvas display list; only needed when the minute or the theme changes
+static void record_canvas() {
   // Special Thanks To https://forums.pebble.com/t/watchface-graphic-stops-drawing-after-watchface-loaded-for-a-while/18982
   // Custom drawing happens here!
-  GRect bounds = layer_get_bounds(layer);
-  #if defined(PBL_ROUND)
-  GRect dial_hand_bounds = GRect(2, 2, bounds.size.w - 4, bounds.size.h - 4);
-  GRect dial_trim_bounds = GRect(12, 12, bounds.size.w - 24, bounds.size.h - 24);
-  GRect center_line_bounds = GRect(bounds.size.w/4, bounds.size.w/4, bounds.size.w/2, bounds.size.w/2);
-  GPoint center = GPoint(bounds.size.w/2, bounds.size.h/2);
-  #else
-  //GRect dial_bounds = GRect(0, bounds.size.h - bounds.size.w/2, bounds.size.w, bounds.size.w);
-  GRect dial_hand_bounds = GRect(2, bounds.size.h - bounds.size.w/2 + 2, bounds.size.w - 4, bounds.size.w - 4);
-  GRect dial_trim_bounds = GRect(12, bounds.size.h - bounds.size.w/2 + 12, bounds.size.w - 24, bounds.size.w - 24);
-  GRect center_line_bounds = GRect(bounds.size.w/4, bounds.size.h - bounds.size.w/4, bounds.size.w/2, bounds.size.w/2);
-  GPoint center = GPoint(bounds.size.w/2, bounds.size.h);
-  //uint16_t radius = bounds.size.w/2;
-  #endif
+  GRect dial_hand_bounds = DIAL_HAND_BOUNDS;
+  GRect dial_trim_bounds = DIAL_TRIM_BOUNDS;
+  GRect center_line_bounds = DIAL_CENTER_LINE_BOUNDS;
+  GPoint center = DIAL_CENTER;
   
   // Draw rectangles to test
   //graphics_draw_rect(ctx, dial_bounds);
@@ -194,16 +253,21 @@ static void canvas_update_proc(Layer *layer, GContext *ctx) {
   //graphics_draw_rect(ctx, center_line_bounds);
   
   // Get the user's preferred start and end times of the day
+  int start_hour = s_view.start_hour;
+  int end_hour = s_view.end_hour;
   time_t start_stamp = clock_to_timestamp(TODAY, start_hour, 0);
   time_t end_stamp = clock_to_timestamp(TODAY, end_hour, 0);
-  time_t now = time(NULL);
+  time_t now = s_view.minute;
+  bool daytime = s_view.daytime;
+  GColor foreground_color = s_view.foreground_color;
   
-  check_daytime();
   int daylight_minutes = daytime ? ((end_hour + 24 - start_hour) % 24) * 60 : ((start_hour + 24 - end_hour) % 24) * 60;
   int daylight_remaining = daytime ? (end_stamp - now) / 60 : (start_stamp - now) / 60;
   
-  graphics_context_set_stroke_color(ctx, foreground_color);
-  graphics_context_set_stroke_width(ctx, 3);
+  DisplayList *list = &s_canvas_list;
+  display_list_reset(list);
+  display_list_set_stroke_color(list, foreground_color);
+  display_list_set_stroke_width(list, 3);
   
   // Draw the hour hand - simple vector graphics version
 
@@ -215,69 +279,399 @@ static void canvas_update_proc(Layer *layer, GContext *ctx) {
   GPoint center_of_sun = gpoint_from_polar(center_line_bounds, GOvalScaleModeFitCircle, hour_angle);
   
   
-  const GPathInfo BOLT_PATH_INFO = {
-    .num_points = 5,
-    .points = (GPoint[]) {center, hour_hand_end, hour_hand_left, hour_hand_end, hour_hand_right}
-  };
-  hour_hand = gpath_create(&BOLT_PATH_INFO);
-  gpath_draw_outline_open(ctx, hour_hand);
-  gpath_destroy(hour_hand);
+  const GPoint bolt_points[] = {center, hour_hand_end, hour_hand_left, hour_hand_end, hour_hand_right};
+  display_list_draw_path_open(list, display_list_add_path(list, bolt_points, ARRAY_LENGTH(bolt_points), GPointZero));
   
-  graphics_fill_circle(ctx, center, 5);
-  graphics_draw_circle(ctx, center, 5);
+  display_list_fill_circle(list, center, 5);
+  display_list_draw_circle(list, center, 5);
   
   if (daytime) { // draw the sun on the hour hand
-    inner_sun = gpath_create(&SUN_INNER_RAYS_INFO);
-    outer_sun = gpath_create(&SUN_OUTER_RAYS_INFO);
-  
-    gpath_move_to(inner_sun, GPoint(center_of_sun.x - sun_offset, center_of_sun.y - sun_offset));
-    gpath_move_to(outer_sun, GPoint(center_of_sun.x - sun_offset, center_of_sun.y - sun_offset));
-  
-    graphics_context_set_stroke_color(ctx, PBL_IF_COLOR_ELSE(foreground_color, foreground_color));
-    graphics_context_set_fill_color(ctx, PBL_IF_COLOR_ELSE(foreground_color, foreground_color));
-    gpath_draw_filled(ctx, inner_sun);
-    gpath_draw_outline(ctx, inner_sun);
-    graphics_context_set_fill_color(ctx, PBL_IF_COLOR_ELSE(GColorChromeYellow, background_color));
-    graphics_context_set_stroke_color(ctx, PBL_IF_COLOR_ELSE(foreground_color, foreground_color));
-    gpath_draw_filled(ctx, outer_sun);
-    gpath_draw_outline(ctx, outer_sun);
-    
-    gpath_destroy(inner_sun);
-    gpath_destroy(outer_sun);
+    GPoint sun_origin = GPoint(center_of_sun.x - SUN_OFFSET, center_of_sun.y - SUN_OFFSET);
+    DisplayListPath inner_sun = display_list_add_path(list, SUN_INNER_RAYS, ARRAY_LENGTH(SUN_INNER_RAYS), sun_origin);
+    DisplayListPath outer_sun = display_list_add_path(list, SUN_OUTER_RAYS, ARRAY_LENGTH(SUN_OUTER_RAYS), sun_origin);
+  
+    display_list_set_stroke_color(list, PBL_IF_COLOR_ELSE(foreground_color, foreground_color));
+    display_list_set_fill_color(list, PBL_IF_COLOR_ELSE(foreground_color, foreground_color));
+    display_list_fill_path(list, inner_sun);
+    display_list_draw_path(list, inner_sun);
+    display_list_set_fill_color(list, PBL_IF_COLOR_ELSE(GColorChromeYellow, s_view.background_color));
+    display_list_set_stroke_color(list, PBL_IF_COLOR_ELSE(foreground_color, foreground_color));
+    display_list_fill_path(list, outer_sun);
+    display_list_draw_path(list, outer_sun);
   
-    GRect mid_sun = GRect(center_of_sun.x - small_sun_radius, center_of_sun.y - small_sun_radius, small_sun_radius*2, small_sun_radius*2);
-    graphics_context_set_fill_color(ctx, PBL_IF_COLOR_ELSE(foreground_color, foreground_color));
-    graphics_fill_radial(ctx, mid_sun, GOvalScaleModeFitCircle, 3, 0, DEG_TO_TRIGANGLE(360));
+    GRect mid_sun = GRect(center_of_sun.x - SMALL_SUN_RADIUS, center_of_sun.y - SMALL_SUN_RADIUS, SMALL_SUN_RADIUS*2, SMALL_SUN_RADIUS*2);
+    display_list_set_fill_color(list, PBL_IF_COLOR_ELSE(foreground_color, foreground_color));
+    display_list_fill_radial(list, mid_sun, 3, 0, DEG_TO_TRIGANGLE(360));
     
   } else { // draw the moon on the hour hand - https://www.xkcd.com/1738/ is acknowledged
-    graphics_context_set_fill_color(ctx, PBL_IF_COLOR_ELSE(GColorLightGray, foreground_color));
-    graphics_context_set_stroke_color(ctx, PBL_IF_COLOR_ELSE(GColorLightGray, foreground_color));
-    graphics_fill_circle(ctx, center_of_sun, moon_outer_radius);
-    graphics_draw_circle(ctx, center_of_sun, moon_outer_radius);
-    graphics_context_set_fill_color(ctx, PBL_IF_COLOR_ELSE(GColorOxfordBlue, background_color));
-    graphics_context_set_stroke_color(ctx, PBL_IF_COLOR_ELSE(GColorOxfordBlue, background_color));
-    graphics_fill_circle(ctx, gpoint_from_polar(center_line_bounds, GOvalScaleModeFitCircle, hour_angle + 2200), moon_inner_radius);
-    graphics_draw_circle(ctx, gpoint_from_polar(center_line_bounds, GOvalScaleModeFitCircle, hour_angle + 2200), moon_inner_radius);
+    GPoint moon_shadow = gpoint_from_polar(center_line_bounds, GOvalScaleModeFitCircle, hour_angle + 2200);
+    display_list_set_fill_color(list, PBL_IF_COLOR_ELSE(GColorLightGray, foreground_color));
+    display_list_set_stroke_color(list, PBL_IF_COLOR_ELSE(GColorLightGray, foreground_color));
+    display_list_fill_circle(list, center_of_sun, MOON_OUTER_RADIUS);
+    display_list_draw_circle(list, center_of_sun, MOON_OUTER_RADIUS);
+    display_list_set_fill_color(list, PBL_IF_COLOR_ELSE(GColorOxfordBlue, s_view.background_color));
+    display_list_set_stroke_color(list, PBL_IF_COLOR_ELSE(GColorOxfordBlue, s_view.background_color));
+    display_list_fill_circle(list, moon_shadow, MOON_INNER_RADIUS);
+    display_list_draw_circle(list, moon_shadow, MOON_INNER_RADIUS);
   }
   
 }
 
+static void redraw_start_update_proc(Layer *layer, GContext *ctx) {
+  trace_record(TraceEventRedrawStart, 0);
+  #if defined(PROFILE)
+  s_frame_started_ms = profile_now_ms();
+  #endif
+}
+
+static void redraw_end_update_proc(Layer *layer, GContext *ctx) {
+  trace_record(TraceEventRedrawEnd, 0);
+  #if defined(PROFILE)
+  LOG_DEBUG("Frame drawn in %d ms, %d bytes of heap in use", (int)(profile_now_ms() - s_frame_started_ms),
+            (int)heap_bytes_used());
+  #endif
+}
+
+static void set_redraw_markers(bool enabled) {
+  if (enabled && !s_redraw_start_layer) {
+    Layer *window_layer = window_get_root_layer(s_main_window);
+    GRect bounds = layer_get_bounds(window_layer);
+    s_redraw_start_layer = layer_create(bounds);
+    layer_set_update_proc(s_redraw_start_layer, redraw_start_update_proc);
+    #if defined(GLYPH_ATLAS)
+    layer_insert_below_sibling(s_redraw_start_layer, s_glyph_atlas_layer);
+    #else
+    layer_insert_below_sibling(s_redraw_start_layer, bitmap_layer_get_layer(s_background_layer));
+    #endif
+    s_redraw_end_layer = layer_create(bounds);
+    layer_set_update_proc(s_redraw_end_layer, redraw_end_update_proc);
+    layer_add_child(window_layer, s_redraw_end_layer);
+  } else if (!enabled && s_redraw_start_layer) {
+    layer_destroy(s_redraw_start_layer);
+    layer_destroy(s_redraw_end_layer);
+    s_redraw_start_layer = NULL;
+    s_redraw_end_layer = NULL;
+  }
+}
+
+#if defined(GLYPH_ATLAS)
+// Drawn first (after the redraw start marker, if any), before the opaque background, so
+// the frame buffer is free to rasterize glyphs into
+static void glyph_atlas_update_proc(Layer *layer, GContext *ctx) {
+  if (s_atlas_daytime == s_view.daytime) {
+    return;
+  }
+  s_atlas_daytime = s_view.daytime;
+  #if defined(PROFILE)
+  int64_t started = profile_now_ms();
+  int heap_before = (int)heap_bytes_used();
+  #endif
+  GRect bounds = layer_get_bounds(layer);
+  GPoint scratch = GPoint(8, bounds.size.h / 2 - 32);
+  glyph_atlas_build(&s_time_atlas, ctx, scratch, s_view.foreground_color, s_view.background_color);
+  glyph_atlas_build(&s_pm_atlas, ctx, scratch, s_view.foreground_color, s_view.background_color);
+  #if defined(PROFILE)
+  LOG_DEBUG("Glyph atlas: built in %d ms, %d bytes of bitmap, %d bytes of heap",
+            (int)(profile_now_ms() - started), (int)(glyph_atlas_get_size(&s_time_atlas) + glyph_atlas_get_size(&s_pm_atlas)),
+            (int)heap_bytes_used() - heap_before);
+  #endif
+}
+
+static void draw_glyph_text(const GlyphAtlas *atlas, GContext *ctx, Layer *layer, const char *text, GFont font,
+                            GTextAlignment alignment) {
+  GRect bounds = layer_get_bounds(layer);
+  if (atlas->ready) {
+    glyph_atlas_draw(atlas, ctx, text, bounds, alignment);
+  } else { // the atlas could not be built; draw the text the slow way
+    graphics_context_set_text_color(ctx, s_view.foreground_color);
+    graphics_draw_text(ctx, text, font, bounds, GTextOverflowModeWordWrap, alignment, NULL);
+  }
+}
+
+static void time_glyph_update_proc(Layer *layer, GContext *ctx) {
+  draw_glyph_text(&s_time_atlas, ctx, layer, s_view.time_text, s_time_font,
+                  clock_is_24h_style() ? GTextAlignmentCenter : GTextAlignmentRight);
+}
+
+static void pm_glyph_update_proc(Layer *layer, GContext *ctx) {
+  draw_glyph_text(&s_pm_atlas, ctx, layer, s_view.pm_text, s_date_font, GTextAlignmentLeft);
+}
+#endif
+
+static void canvas_update_proc(Layer *layer, GContext *ctx) {
+  display_list_replay(&s_canvas_list, ctx);
+  #if defined(PROFILE)
+  s_frames_drawn++;
+  if (!s_first_frame_logged) {
+    s_first_frame_logged = true;
+    LOG_DEBUG("Launch to first frame: %d ms", (int)(profile_now_ms() - s_launch_ms));
+  }
+  LOG_DEBUG("Canvas replay: %d ops, %d bytes, %d ms", s_canvas_list.num_ops,
+          (int)display_list_get_size(&s_canvas_list), display_list_get_replay_ms(&s_canvas_list));
+  #endif
+}
+
+// Push the differences between the previous and current view model into the
+// layers, so only layers whose inputs changed get invalidated
+static void mark_dirty(Layer *layer) {
+  layer_mark_dirty(layer);
+  #if defined(PROFILE)
+  s_layers_invalidated++;
+  #endif
+}
+
+// Returns true if the text was set, which marks the layer dirty
+static bool apply_text(TextLayer *layer, const char *old_text, const char *new_text, bool force) {
+  if (!force && strcmp(old_text, new_text) == 0) {
+    return false;
+  }
+  text_layer_set_text(layer, new_text);
+  #if defined(PROFILE)
+  s_layers_invalidated++;
+  #endif
+  return true;
+}
+
+static GBitmap *battery_icon_for(const ViewModel *vm) {
+  if (vm->battery_charging) {
+    return vm->daytime ? s_battery_icon_plus : s_battery_icon_plus_dark;
+  }
+  return vm->daytime ? s_battery_icon : s_battery_icon_dark;
+}
+
+static GBitmap *bt_icon_for(const ViewModel *vm) {
+  switch (vm->bt_icon) {
+    case BtIconOn:
+      return vm->daytime ? s_bt_icon_on_bitmap : s_bt_icon_on_bitmap_dark;
+    case BtIconOff:
+      return vm->daytime ? s_bt_icon_off_bitmap : s_bt_icon_off_bitmap_dark;
+    default:
+      return vm->daytime ? s_bt_icon_bitmap : s_bt_icon_bitmap_dark;
+  }
+}
+
+// The face itself: background, time and the canvas. The pieces around it are
+// complication slots, applied below.
+static void apply_view_model(const ViewModel *prev, bool force) {
+  const ViewModel *vm = &s_view;
+  bool theme_changed = force || prev->daytime != vm->daytime;
+
+  if (theme_changed) {
+    bitmap_layer_set_bitmap(s_background_layer, vm->daytime ? s_background_bitmap_day : s_background_bitmap_night);
+    #if defined(GLYPH_ATLAS)
+    mark_dirty(s_time_glyph_layer);
+    #if defined(PROFILE)
+    s_layers_invalidated += 1; // the background
+    #endif
+    #else
+    text_layer_set_text_color(s_time_layer, vm->foreground_color);
+    #if defined(PROFILE)
+    s_layers_invalidated += 2; // the background and the time
+    #endif
+    #endif
+  }
+
+  #if defined(GLYPH_ATLAS)
+  if (force || strcmp(prev->time_text, vm->time_text) != 0) {
+    mark_dirty(s_time_glyph_layer);
+  }
+  #else
+  apply_text(s_time_layer, prev->time_text, vm->time_text, force);
+  #endif
+
+  if (theme_changed || prev->minute != vm->minute || prev->start_hour != vm->start_hour || prev->end_hour != vm->end_hour) {
+    record_canvas();
+    mark_dirty(s_canvas_layer);
+  }
+}
+
+// Complication slots. Each apply proc diffs s_prev_view against s_view for
+// its own fields; a theme or sleep change forces all of them.
+static ViewModel s_prev_view;
+
+static bool battery_slot_apply(ComplicationSlot *slot, bool force) {
+  const ViewModel *prev = &s_prev_view, *vm = &s_view;
+  if (force || prev->battery_charging != vm->battery_charging) {
+    bitmap_layer_set_bitmap(s_battery_icon_layer, battery_icon_for(vm));
+  }
+  if (force || prev->battery_shown != vm->battery_shown) {
+    layer_set_hidden(slot->layer, !vm->battery_shown);
+  }
+  bool dirty = force || (vm->battery_shown && (prev->battery_level != vm->battery_level ||
+                                               !gcolor_equal(prev->battery_color, vm->battery_color)));
+  if (dirty) {
+    mark_dirty(slot->layer);
+  }
+  return dirty;
+}
+
+static bool bluetooth_slot_apply(ComplicationSlot *slot, bool force) {
+  const ViewModel *prev = &s_prev_view, *vm = &s_view;
+  if (force || prev->bt_icon != vm->bt_icon) {
+    bitmap_layer_set_bitmap(s_bt_icon_layer, bt_icon_for(vm));
+  }
+  if (force || prev->bt_shown != vm->bt_shown) {
+    layer_set_hidden(slot->layer, !vm->bt_shown);
+  }
+  return false;
+}
+
+static bool date_slot_apply(ComplicationSlot *slot, bool force) {
+  const ViewModel *prev = &s_prev_view, *vm = &s_view;
+  if (force) {
+    text_layer_set_text_color(s_day_layer, vm->foreground_color);
+    text_layer_set_text_color(s_date_layer, vm->foreground_color);
+  }
+  bool day_dirty = apply_text(s_day_layer, prev->day_text, vm->day_text, force);
+  bool date_dirty = apply_text(s_date_layer, prev->date_text, vm->date_text, force);
+  return day_dirty || date_dirty;
+}
+
+static bool pm_slot_apply(ComplicationSlot *slot, bool force) {
+  const ViewModel *prev = &s_prev_view, *vm = &s_view;
+  #if defined(GLYPH_ATLAS)
+  bool dirty = force || strcmp(prev->pm_text, vm->pm_text) != 0;
+  if (dirty) {
+    mark_dirty(slot->layer);
+  }
+  return dirty;
+  #else
+  if (force) {
+    text_layer_set_text_color(s_pm_layer, vm->foreground_color);
+  }
+  return apply_text(s_pm_layer, prev->pm_text, vm->pm_text, force);
+  #endif
+}
+
+// Frames and layers are filled in by main_window_load. A steps slot, say,
+// would be one more entry here fed by ComplicationSourceHealth.
+enum {
+  SlotBattery,
+  SlotBluetooth,
+  SlotDate,
+  SlotPm,
+  NUM_SLOTS
+};
+
+static ComplicationSlot s_slots[NUM_SLOTS] = {
+  [SlotBattery] = {
+    .name = "battery",
+    .sources = ComplicationSourceBattery | ComplicationSourceSettings,
+    .apply = battery_slot_apply
+  },
+  [SlotBluetooth] = {
+    .name = "bluetooth",
+    .sources = ComplicationSourceConnection | ComplicationSourceSettings,
+    .apply = bluetooth_slot_apply
+  },
+  [SlotDate] = {
+    .name = "date",
+    .cadence = DAY_UNIT,
+    .apply = date_slot_apply
+  },
+  [SlotPm] = {
+    .name = "am/pm",
+    // 12h/24h is a system preference, set in the Settings app, which relaunches
+    // the face on exit; load applies it with everything else
+    .cadence = HOUR_UNIT,
+    .apply = pm_slot_apply
+  },
+};
+
+// Runs once per flush, before the pending slots are applied
+static bool refresh_view() {
+  s_prev_view = s_view;
+  build_view_model(&s_view);
+  apply_view_model(&s_prev_view, false);
+
+  if (s_prev_view.daytime != s_view.daytime) {
+    trace_record(TraceEventThemeSwap, s_view.daytime);
+  }
+  return s_prev_view.daytime != s_view.daytime || s_prev_view.asleep != s_view.asleep;
+}
+
+// Runs once the flush has applied the slots too, so the counts cover
+// everything the event invalidated
+static void view_flushed() {
+  #if defined(PROFILE)
+  LOG_DEBUG("Refresh: %d layers invalidated, %d frames drawn since last refresh",
+          s_layers_invalidated, s_frames_drawn);
+  s_layers_invalidated = 0;
+  s_frames_drawn = 0;
+  #endif
+}
+
+static void tick_handler(struct tm *tick_time, TimeUnits units_changed);
+
+static bool in_quiet_window(int hour) {
+  int quiet_start = enamel_get_QuietStart();
+  int quiet_end = enamel_get_QuietEnd();
+  if (quiet_start <= quiet_end) {
+    return hour >= quiet_start && hour < quiet_end;
+  }
+  return hour >= quiet_start || hour < quiet_end; // the window wraps past midnight
+}
+
+static bool wearer_asleep() {
+  #if defined(PBL_HEALTH)
+  if (strcmp(enamel_get_SleepQuiet(), "yes") == 0 &&
+      (health_service_peek_current_activities() & (HealthActivitySleep | HealthActivityRestfulSleep))) {
+    return true;
+  }
+  #endif
+  if (strcmp(enamel_get_QuietWindow(), "yes") == 0) {
+    time_t now = time(NULL);
+    return in_quiet_window(localtime(&now)->tm_hour);
+  }
+  return false;
+}
+
+// Switch between minute and hourly ticks as the wearer falls asleep or wakes;
+// returns true if the state changed
+static bool update_sleep_state() {
+  bool asleep = wearer_asleep();
+  if (asleep == s_asleep) {
+    return false;
+  }
+  s_asleep = asleep;
+  trace_record(TraceEventSleep, asleep);
+  tick_timer_service_subscribe(asleep ? HOUR_UNIT : MINUTE_UNIT, tick_handler);
+  return true;
+}
+
+static void tick_handler(struct tm *tick_time, TimeUnits units_changed) {
+  trace_record(TraceEventTick, units_changed);
+  update_sleep_state();
+  complications_schedule(0, units_changed);
+  complications_flush();
+}
+
+#if defined(PBL_HEALTH)
+static void health_handler(HealthEventType event, void *context) {
+  // Waking up gets one catch-up redraw here rather than waiting for the next hourly tick
+  if ((event == HealthEventSleepUpdate || event == HealthEventSignificantUpdate) && update_sleep_state()) {
+    complications_schedule(ComplicationSourceHealth, 0);
+    complications_flush();
+  }
+}
+#endif
+
+static void battery_callback(BatteryChargeState state) {
+  // Record the new battery level
+  s_battery_level = state.charge_percent;
+  s_battery_charging = state.is_charging;
+  trace_record(TraceEventBattery, state.charge_percent | (state.is_charging ? 0x80 : 0));
+  // Update meter
+  complications_schedule(ComplicationSourceBattery, 0);
+  complications_flush();
+}
+
 static void battery_update_proc(Layer *layer, GContext *ctx) {
   
-  if (strcmp(enamel_get_BatteryStatus(), "yes") == 0 || (strcmp(enamel_get_BatteryStatus(), "low") == 0 && (s_battery_level < 30 || s_battery_charging))) {
+  if (s_view.battery_shown) {
     
-    GColor battery_color;
-    
-    #if defined(PBL_COLOR)
-    if (s_battery_level > 30) {
-      battery_color = GColorKellyGreen;
-    } else if (s_battery_level > 10) {
-      battery_color = GColorChromeYellow;
-    } else {
-      battery_color = GColorDarkCandyAppleRed;
-    }
-    #else
-      battery_color = background_color;
+    #if defined(PROFILE)
+    s_frames_drawn++;
     #endif
     
     #if defined(PBL_ROUND)
@@ -287,15 +681,14 @@ static void battery_update_proc(Layer *layer, GContext *ctx) {
     GRect front_of_bar = GRect(3, 3, bounds.size.w - 6, bounds.size.h - 6);
     
     // Find the width of the bar
-    int width = (int)(float)(((float)s_battery_level / 100.0F) * (90.0F));
+    int width = (int)(float)(((float)s_view.battery_level / 100.0F) * (90.0F));
     
     // Draw the background
-    graphics_context_set_fill_color(ctx, foreground_color);
+    graphics_context_set_fill_color(ctx, s_view.foreground_color);
     graphics_fill_radial(ctx, back_of_bar, GOvalScaleModeFitCircle, 8, DEG_TO_TRIGANGLE(133), DEG_TO_TRIGANGLE(227));
     
     // Draw the bar
-    graphics_context_set_fill_color(ctx, battery_color);
-    //APP_LOG(APP_LOG_LEVEL_ERROR, "Battery level: %d", s_battery_level);
+    graphics_context_set_fill_color(ctx, s_view.battery_color);
     graphics_fill_radial(ctx, front_of_bar, GOvalScaleModeFitCircle, 4, DEG_TO_TRIGANGLE(225 - width), DEG_TO_TRIGANGLE(225));
     // Not sure what's going on there - possibly the emulator always assumes standard Pebble battery capacity
     
@@ -305,66 +698,54 @@ static void battery_update_proc(Layer *layer, GContext *ctx) {
     GRect back_of_bar = GRect(25, 1, bounds.size.w - 50, 8);
   
     // Find the width of the bar
-    int width = (int)(float)(((float)s_battery_level / 100.0F) * (back_of_bar.size.w - 4.0F));
+    int width = (int)(float)(((float)s_view.battery_level / 100.0F) * (back_of_bar.size.w - 4.0F));
 
     // Draw the background
-    graphics_context_set_fill_color(ctx, foreground_color);
+    graphics_context_set_fill_color(ctx, s_view.foreground_color);
     graphics_fill_rect(ctx, back_of_bar, 0, GCornerNone);
 
     // Draw the bar
-    graphics_context_set_fill_color(ctx, battery_color);
+    graphics_context_set_fill_color(ctx, s_view.battery_color);
     graphics_fill_rect(ctx, GRect(27, 3, width, 4), 0, GCornerNone);
     #endif
     
-    if (s_battery_charging) {
-      bitmap_layer_set_bitmap(s_battery_icon_layer, daytime ? s_battery_icon_plus : s_battery_icon_plus_dark);
-    } else { //if (s_battery_level < 30) {
-      bitmap_layer_set_bitmap(s_battery_icon_layer, daytime ? s_battery_icon : s_battery_icon_dark);
-    }
-    layer_set_hidden(bitmap_layer_get_layer(s_battery_icon_layer), false);
-    
-  } else {
-    layer_set_hidden(bitmap_layer_get_layer(s_battery_icon_layer), true);
   }
 
 }
 
-static void update_bluetooth_pictures(bool connected) {
-  if (connected) {
-      bitmap_layer_set_bitmap(s_bt_icon_layer, daytime ? s_bt_icon_on_bitmap : s_bt_icon_on_bitmap_dark);
-      layer_set_hidden(bitmap_layer_get_layer(s_bt_icon_layer), !strcmp(enamel_get_BluetoothStatus(), "yes") == 0);
-  } else {
-    if (strcmp(enamel_get_BluetoothStatus(), "yes") == 0) {
-      bitmap_layer_set_bitmap(s_bt_icon_layer, daytime ? s_bt_icon_off_bitmap : s_bt_icon_off_bitmap_dark);
-      layer_set_hidden(bitmap_layer_get_layer(s_bt_icon_layer), false);
-    } else if (strcmp(enamel_get_BluetoothStatus(), "disconnected") == 0) {
-      bitmap_layer_set_bitmap(s_bt_icon_layer, daytime ? s_bt_icon_bitmap : s_bt_icon_bitmap_dark);
-      layer_set_hidden(bitmap_layer_get_layer(s_bt_icon_layer), false);
-    } else {
-      layer_set_hidden(bitmap_layer_get_layer(s_bt_icon_layer), true);
-    }
-  }
-}
-
 static void bluetooth_callback(bool connected) {
-  //APP_LOG(APP_LOG_LEVEL_DEBUG, "Bluetooth callback");
-  
-  if(!connected && strcmp(enamel_get_BluetoothDisconnect(), "yes") == 0) {
+  trace_record(TraceEventBluetooth, connected);
+
+  // Don't wake the wearer; the icon still updates for when they do
+  bool vibrate = !s_asleep;
+  if(vibrate && !connected && strcmp(enamel_get_BluetoothDisconnect(), "yes") == 0) {
     vibes_enqueue_custom_pattern(SIGNAL_LOST);
-  } else if (connected && strcmp(enamel_get_BluetoothConnect(), "yes") == 0) {
+  } else if (vibrate && connected && strcmp(enamel_get_BluetoothConnect(), "yes") == 0) {
     vibes_enqueue_custom_pattern(SIGNAL_FOUND);
   }
-  update_bluetooth_pictures(connected);
-  layer_mark_dirty(s_bt_layer);
+  s_bt_connected = connected;
+  complications_schedule(ComplicationSourceConnection, 0);
+  complications_flush();
 }
 
 static void enamel_settings_received_boundary_handler(void *context){
-  APP_LOG(0, "Settings received %d", (int)enamel_get_DayStart());
-  APP_LOG(0, "Settings received %d", (int)enamel_get_DayEnd());
   start_hour = enamel_get_DayStart();
   end_hour = enamel_get_DayEnd();
-  check_daytime();
-  update_bluetooth_pictures(connection_service_peek_pebble_app_connection());
+  LOG_DEBUG("Settings received: day %d-%d", start_hour, end_hour);
+  trace_record(TraceEventSettings, 0);
+  update_sleep_state();
+  complications_schedule(ComplicationSourceSettings, 0);
+
+  // Turning diagnostics on hands the trace to the phone, once
+  bool diagnostics = strcmp(enamel_get_Diagnostics(), "yes") == 0;
+  if (diagnostics && !s_diagnostics) {
+    trace_send();
+  }
+  s_diagnostics = diagnostics;
+  #if !defined(PROFILE)
+  set_redraw_markers(diagnostics);
+  #endif
+  complications_flush();
 }
 
 static void main_window_load(Window *window) {
@@ -378,11 +759,16 @@ static void main_window_load(Window *window) {
   s_background_bitmap_day = gbitmap_create_with_resource(RESOURCE_ID_IMAGE_DAY_ON_WHITE);
   s_background_bitmap_night = gbitmap_create_with_resource(RESOURCE_ID_IMAGE_NIGHT_ON_BLACK);
 
+  #if defined(GLYPH_ATLAS)
+  s_glyph_atlas_layer = layer_create(bounds);
+  layer_set_update_proc(s_glyph_atlas_layer, glyph_atlas_update_proc);
+  layer_add_child(window_layer, s_glyph_atlas_layer);
+  #endif
+
   // Create BitmapLayer to display the GBitmap
   s_background_layer = bitmap_layer_create(bounds);
 
-  // Set the bitmap onto the layer and add to the window
-  bitmap_layer_set_bitmap(s_background_layer, daytime ? s_background_bitmap_day : s_background_bitmap_night);
+  // Add to the window; the bitmap is set once the view model is applied
   layer_add_child(window_layer, bitmap_layer_get_layer(s_background_layer));
 
   // Create canvas layer
@@ -390,37 +776,48 @@ static void main_window_load(Window *window) {
   
   int offset = bounds.size.w == 144 ? 50 : 70;
   #if defined(PBL_ROUND)
-  // Create the time TextLayer with specific bounds
-  s_time_layer = text_layer_create(
-      clock_is_24h_style() ? GRect(0, bounds.size.h*(13.0/21), bounds.size.w, 50) : GRect(0, bounds.size.h*(13.0/21), bounds.size.w-70, 50));
+  // Work out the time TextLayer's bounds
+  GRect time_frame =
+      clock_is_24h_style() ? GRect(0, bounds.size.h*(13.0/21), bounds.size.w, 50) : GRect(0, bounds.size.h*(13.0/21), bounds.size.w-70, 50);
   
-  // Create the day and date TextLayer with specific bounds
+  // Create the day and date TextLayer side by side inside the date slot
+  s_slots[SlotDate].frame = GRect(0, bounds.size.h*(44.0/84), bounds.size.w, 35);
   s_day_layer = text_layer_create(
-      GRect(0, bounds.size.h*(44.0/84), bounds.size.w/2, 35));
+      GRect(0, 0, bounds.size.w/2, 35));
   
   s_date_layer = text_layer_create(
-      GRect(bounds.size.w/2, bounds.size.h*(44.0/84), bounds.size.w/2, 35));
+      GRect(bounds.size.w/2, 0, bounds.size.w/2, 35));
   
   // Create AM/PM layer
-  s_pm_layer = text_layer_create(
-      GRect(bounds.size.w - 66, bounds.size.h*(13.0/21) + 13, 30, 25));
+  s_slots[SlotPm].frame = GRect(bounds.size.w - 66, bounds.size.h*(13.0/21) + 13, 30, 25);
   
   #else
-  // Create the time TextLayer with specific bounds
-  s_time_layer = text_layer_create(
+  // Work out the time TextLayer's bounds
+  GRect time_frame =
       //clock_is_24h_style() ? GRect(0, 48, bounds.size.w, 50) : GRect(0, 48, bounds.size.w-50, 50));
-      clock_is_24h_style() ? GRect(0, bounds.size.h*(6.0/21), bounds.size.w, 50) : GRect(0, bounds.size.h*(6.0/21), bounds.size.w-offset, 70));
+      clock_is_24h_style() ? GRect(0, bounds.size.h*(6.0/21), bounds.size.w, 50) : GRect(0, bounds.size.h*(6.0/21), bounds.size.w-offset, 70);
   
-  // Create the day and date TextLayer with specific bounds
+  // Create the day and date TextLayer one above the other inside the date slot
+  int day_y = bounds.size.h*(5.0/84);
+  int date_y = bounds.size.h*(15.0/84);
+  s_slots[SlotDate].frame = GRect(0, day_y, bounds.size.w, date_y - day_y + 35);
   s_day_layer = text_layer_create(
-      GRect(0, bounds.size.h*(5.0/84), bounds.size.w, 35));
+      GRect(0, 0, bounds.size.w, 35));
   
   s_date_layer = text_layer_create(
-      GRect(0, bounds.size.h*(15.0/84), bounds.size.w, 35));
+      GRect(0, date_y - day_y, bounds.size.w, 35));
   
   // Create AM/PM layer
-  s_pm_layer = text_layer_create(
-      GRect(bounds.size.w - (offset - 4), bounds.size.h*(6.0/21) + 13, 40, 35));
+  s_slots[SlotPm].frame = GRect(bounds.size.w - (offset - 4), bounds.size.h*(6.0/21) + 13, 40, 35);
+  #endif
+  #if defined(GLYPH_ATLAS)
+  s_time_glyph_layer = layer_create(time_frame);
+  s_pm_glyph_layer = layer_create(s_slots[SlotPm].frame);
+  s_slots[SlotPm].layer = s_pm_glyph_layer;
+  #else
+  s_time_layer = text_layer_create(time_frame);
+  s_pm_layer = text_layer_create(s_slots[SlotPm].frame);
+  s_slots[SlotPm].layer = text_layer_get_layer(s_pm_layer);
   #endif
   
   // Create GFont
@@ -433,25 +830,31 @@ static void main_window_load(Window *window) {
   #endif
 
   // Improve the layout to be more like a watchface
+  #if defined(GLYPH_ATLAS)
+  glyph_atlas_init(&s_time_atlas, s_time_font, TIME_GLYPHS, ARRAY_LENGTH(TIME_GLYPHS));
+  glyph_atlas_init(&s_pm_atlas, s_date_font, PM_GLYPHS, ARRAY_LENGTH(PM_GLYPHS));
+  s_atlas_daytime = -1;
+  layer_set_update_proc(s_time_glyph_layer, time_glyph_update_proc);
+  layer_set_update_proc(s_pm_glyph_layer, pm_glyph_update_proc);
+  #else
   text_layer_set_background_color(s_time_layer, GColorClear);
-  text_layer_set_text_color(s_time_layer, foreground_color);
   text_layer_set_font(s_time_layer, s_time_font);
   text_layer_set_text_alignment(s_time_layer, clock_is_24h_style() ? GTextAlignmentCenter: GTextAlignmentRight);
+  #endif
   
   text_layer_set_background_color(s_day_layer, GColorClear);
-  text_layer_set_text_color(s_day_layer, foreground_color);
   text_layer_set_font(s_day_layer, s_date_font);
   text_layer_set_text_alignment(s_day_layer, GTextAlignmentCenter);
   
   text_layer_set_background_color(s_date_layer, GColorClear);
-  text_layer_set_text_color(s_date_layer, foreground_color);
   text_layer_set_font(s_date_layer, s_date_font);
   text_layer_set_text_alignment(s_date_layer, GTextAlignmentCenter);
   
+  #if !defined(GLYPH_ATLAS)
   text_layer_set_background_color(s_pm_layer, GColorClear);
-  text_layer_set_text_color(s_pm_layer, foreground_color);
   text_layer_set_font(s_pm_layer, s_date_font);
   text_layer_set_text_alignment(s_pm_layer, GTextAlignmentLeft);
+  #endif
   
   // Assign the custom drawing procedure
   layer_set_update_proc(s_canvas_layer, canvas_update_proc);
@@ -460,13 +863,21 @@ static void main_window_load(Window *window) {
   layer_add_child(window_get_root_layer(window), s_canvas_layer);
   
   // Add text fields to Window
+  #if defined(GLYPH_ATLAS)
+  layer_add_child(window_layer, s_time_glyph_layer);
+  #else
   layer_add_child(window_layer, text_layer_get_layer(s_time_layer));
-  layer_add_child(window_layer, text_layer_get_layer(s_day_layer));
-  layer_add_child(window_layer, text_layer_get_layer(s_date_layer));
-  layer_add_child(window_layer, text_layer_get_layer(s_pm_layer));
+  #endif
+  s_slots[SlotDate].layer = layer_create(s_slots[SlotDate].frame);
+  layer_add_child(s_slots[SlotDate].layer, text_layer_get_layer(s_day_layer));
+  layer_add_child(s_slots[SlotDate].layer, text_layer_get_layer(s_date_layer));
+  layer_add_child(window_layer, s_slots[SlotDate].layer);
+  layer_add_child(window_layer, s_slots[SlotPm].layer);
 
   // Create battery meter Layer
-  s_battery_layer = layer_create(GRect(0, 0, bounds.size.w, PBL_IF_ROUND_ELSE(bounds.size.h, bounds.size.h/4)));
+  s_slots[SlotBattery].frame = GRect(0, 0, bounds.size.w, PBL_IF_ROUND_ELSE(bounds.size.h, bounds.size.h/4));
+  s_battery_layer = layer_create(s_slots[SlotBattery].frame);
+  s_slots[SlotBattery].layer = s_battery_layer;
   layer_set_update_proc(s_battery_layer, battery_update_proc);
 
   // Add to Window
@@ -478,10 +889,10 @@ static void main_window_load(Window *window) {
   s_battery_icon_dark = gbitmap_create_with_resource(RESOURCE_ID_IMAGE_BATTERY_ICON_DARK);
   s_battery_icon_plus_dark = gbitmap_create_with_resource(RESOURCE_ID_IMAGE_BATTERY_ICON_PLUS_DARK);
   
-  // Create the BitmapLayer to display the battery icon
+  // Create the BitmapLayer to display the battery icon; it lives inside the
+  // meter so the slot shows and hides as one
   s_battery_icon_layer = bitmap_layer_create(PBL_IF_ROUND_ELSE(GRect(65, 150, 21, 9), GRect(0, 0, 21, 9)));
-  bitmap_layer_set_bitmap(s_battery_icon_layer, s_battery_icon);
-  layer_add_child(window_get_root_layer(window), bitmap_layer_get_layer(s_battery_icon_layer));
+  layer_add_child(s_battery_layer, bitmap_layer_get_layer(s_battery_icon_layer));
   
   // Create the Bluetooth icon GBitmap
   s_bt_icon_bitmap = gbitmap_create_with_resource(RESOURCE_ID_IMAGE_BLUETOOTH);
@@ -492,21 +903,46 @@ static void main_window_load(Window *window) {
   s_bt_icon_off_bitmap_dark = gbitmap_create_with_resource(RESOURCE_ID_IMAGE_BLUETOOTH_OFF_DARK);
 
   // Create the BitmapLayer to display the Bluetooth icon GBitmap
-  //s_bt_layer = layer_create(GRect(bounds.size.w - 22, 4, 18, 18));
-  s_bt_layer = layer_create(PBL_IF_ROUND_ELSE(GRect(95, 145, 18, 18), GRect(bounds.size.w - 22, 4, 18, 18)));
-  s_bt_icon_layer = bitmap_layer_create(PBL_IF_ROUND_ELSE(GRect(95, 147, 18, 18), GRect(bounds.size.w - 22, 4, 18, 18)));
+  s_slots[SlotBluetooth].frame = PBL_IF_ROUND_ELSE(GRect(95, 147, 18, 18), GRect(bounds.size.w - 22, 4, 18, 18));
+  s_bt_icon_layer = bitmap_layer_create(s_slots[SlotBluetooth].frame);
+  s_slots[SlotBluetooth].layer = bitmap_layer_get_layer(s_bt_icon_layer);
   layer_add_child(window_get_root_layer(window), bitmap_layer_get_layer(s_bt_icon_layer));
+
+  #if defined(PROFILE)
+  // Profile builds always time their frames
+  set_redraw_markers(true);
+  #else
+  set_redraw_markers(s_diagnostics);
+  #endif
+
+  // The view model was built before the window was pushed, so every layer
+  // starts out with its final theme and text and the first frame is the only one
+  s_prev_view = s_view;
+  apply_view_model(&s_view, true);
+  complications_init(s_slots, NUM_SLOTS, refresh_view, view_flushed);
+  complications_apply_all();
   }
 
 static void main_window_unload(Window *window) {
+  complications_deinit();
+
   // Destroy TextLayer
+  #if defined(GLYPH_ATLAS)
+  layer_destroy(s_time_glyph_layer);
+  layer_destroy(s_pm_glyph_layer);
+  layer_destroy(s_glyph_atlas_layer);
+  glyph_atlas_destroy(&s_time_atlas);
+  glyph_atlas_destroy(&s_pm_atlas);
+  #else
   text_layer_destroy(s_time_layer);
+  text_layer_destroy(s_pm_layer);
+  #endif
   text_layer_destroy(s_day_layer);
   text_layer_destroy(s_date_layer);
-  text_layer_destroy(s_pm_layer);
+  layer_destroy(s_slots[SlotDate].layer);
   layer_destroy(s_canvas_layer);
   layer_destroy(s_battery_layer);
-  //APP_LOG(APP_LOG_LEVEL_ERROR, "Destroyed text layers");
+  set_redraw_markers(false);
   
   
   // Destroy GBitmap
@@ -518,20 +954,16 @@ static void main_window_unload(Window *window) {
   gbitmap_destroy(s_battery_icon_dark);
   gbitmap_destroy(s_battery_icon_plus_dark);
   bitmap_layer_destroy(s_battery_icon_layer);
-  //APP_LOG(APP_LOG_LEVEL_ERROR, "Destroyed bitmaps");
 
   // Destroy the PDC image
   gdraw_command_image_destroy(s_command_image);
-  //APP_LOG(APP_LOG_LEVEL_ERROR, "Destroyed s_command_image");
 
   // Destroy BitmapLayer
   bitmap_layer_destroy(s_background_layer);
-  //APP_LOG(APP_LOG_LEVEL_ERROR, "Destroyed s_background_layer");
   
   // Unload GFont
   fonts_unload_custom_font(s_time_font);
   fonts_unload_custom_font(s_date_font);
-  //APP_LOG(APP_LOG_LEVEL_ERROR, "Destroyed fonts");
   
   // Unload the bluetooth stuff
   gbitmap_destroy(s_bt_icon_bitmap);
@@ -541,11 +973,39 @@ static void main_window_unload(Window *window) {
   gbitmap_destroy(s_bt_icon_off_bitmap);
   gbitmap_destroy(s_bt_icon_off_bitmap_dark);
   bitmap_layer_destroy(s_bt_icon_layer);
-  layer_destroy(s_bt_layer);
 
 }
 
 static void init() {
+  #if defined(PROFILE)
+  s_launch_ms = profile_now_ms();
+  #endif
+
+  // Initialize Enamel to register App Message handlers and restores settings,
+  // before anything reads them
+  enamel_init();
+
+  // The trace asks pebble-events for outbox space, so it also goes before the open
+  trace_init();
+
+  // call pebble-events app_message_open function
+  events_app_message_open(); 
+
+  // Get Start and End hour preferences
+  start_hour = enamel_get_DayStart(); // https://github.com/gregoiresage/enamel Step 5, https://developer.pebble.com/guides/user-interfaces/app-configuration/ Persisting Settings
+  end_hour = enamel_get_DayEnd();
+  s_diagnostics = strcmp(enamel_get_Diagnostics(), "yes") == 0;
+
+  // Ensure battery level and BT connection are displayed from the start
+  BatteryChargeState battery = battery_state_service_peek();
+  s_battery_level = battery.charge_percent;
+  s_battery_charging = battery.is_charging;
+  s_bt_connected = connection_service_peek_pebble_app_connection();
+
+  // Theme, time strings and icons are all known now
+  s_asleep = wearer_asleep();
+  build_view_model(&s_view);
+
   // Create main Window element and assign to pointer
   s_main_window = window_create();
 
@@ -554,31 +1014,16 @@ static void init() {
     .load = main_window_load,
     .unload = main_window_unload
   });
-  
-  // Register with TickTimerService
-  tick_timer_service_subscribe(MINUTE_UNIT, tick_handler);
-  
-  // Register for battery level updates
-  battery_state_service_subscribe(battery_callback);
 
   // Show the Window on the watch, with animated=true
   window_stack_push(s_main_window, true);
-  
-  // Make sure the time is displayed from the start
-  update_time();
-  
-  // Ensure battery level is displayed from the start
-  battery_callback(battery_state_service_peek());
-  
-  // Initialize Enamel to register App Message handlers and restores settings
-  enamel_init();
 
-  // call pebble-events app_message_open function
-  events_app_message_open(); 
+  // Register with TickTimerService, hourly if the wearer is already asleep
+  tick_timer_service_subscribe(s_asleep ? HOUR_UNIT : MINUTE_UNIT, tick_handler);
+  
+  // Register for battery level updates
+  battery_state_service_subscribe(battery_callback);
 
-  // Get Start and End hour preferences
-  start_hour = enamel_get_DayStart(); // change this so it only happens when the app starts or the user submits changes
-  end_hour = enamel_get_DayEnd(); // https://github.com/gregoiresage/enamel Step 5, https://developer.pebble.com/guides/user-interfaces/app-configuration/ Persisting Settings
   s_boundary_handle = enamel_settings_received_subscribe(enamel_settings_received_boundary_handler, s_main_window);
   
   // Register for Bluetooth connection updates
@@ -586,24 +1031,25 @@ static void init() {
   .pebble_app_connection_handler = bluetooth_callback
   });
 
-  // Show the correct state of the BT connection from the start
-  check_daytime();
-  update_bluetooth_pictures(connection_service_peek_pebble_app_connection());
-  APP_LOG(APP_LOG_LEVEL_DEBUG, "First callback");
+  #if defined(PBL_HEALTH)
+  // Register for sleep updates to switch to quiet mode overnight
+  health_service_events_subscribe(health_handler, NULL);
+  #endif
 }
 
 static void deinit() {
   // Destroy Window
   window_destroy(s_main_window);
-  //APP_LOG(APP_LOG_LEVEL_ERROR, "Destroyed s_main_window");
   
   // Deinit Enamel to unregister App Message handlers and save settings
   enamel_settings_received_unsubscribe(s_boundary_handle);
   enamel_deinit();
+  trace_deinit();
 }
 
 int main(void) {
   init();
   app_event_loop();
   deinit();
+  return 0;
 }
\ No newline at end of file
@@ -0,0 +1,139 @@
+#include <pebble.h>
+#include <pebble-events/pebble-events.h>
+#include "trace.h"
+#include "log.h"
+
+// On the wire every TraceData message is a byte array: a version byte, the
+// index of its first entry and the total number of entries, then up to
+// TRACE_CHUNK_ENTRIES entries of 8 little-endian bytes each: uint32 seconds,
+// uint16 milliseconds, uint8 event type, uint8 argument.
+#define TRACE_VERSION 1
+#define TRACE_HEADER_SIZE 3
+#define TRACE_ENTRY_SIZE 8
+#define TRACE_CHUNK_ENTRIES 32
+#define TRACE_CHUNK_SIZE (TRACE_HEADER_SIZE + TRACE_CHUNK_ENTRIES * TRACE_ENTRY_SIZE)
+
+typedef struct {
+  uint32_t seconds;
+  uint16_t ms;
+  uint8_t type;
+  uint8_t arg;
+} TraceEntry;
+
+static TraceEntry s_entries[TRACE_CAPACITY];
+static uint8_t s_head; // where the next entry goes
+static uint8_t s_count;
+
+// The entries being sent, copied out so recording can carry on meanwhile
+static TraceEntry *s_sending;
+static uint8_t s_sending_count;
+static uint8_t s_sent;
+
+static EventHandle s_sent_handle, s_failed_handle;
+
+void trace_record(TraceEventType type, uint8_t arg) {
+  TraceEntry *entry = &s_entries[s_head];
+  time_t seconds;
+  time_ms(&seconds, &entry->ms);
+  entry->seconds = (uint32_t)seconds;
+  entry->type = type;
+  entry->arg = arg;
+  s_head = (s_head + 1) % TRACE_CAPACITY;
+  if (s_count < TRACE_CAPACITY) {
+    s_count++;
+  }
+}
+
+static void prv_write_entry(uint8_t *out, const TraceEntry *entry) {
+  out[0] = entry->seconds;
+  out[1] = entry->seconds >> 8;
+  out[2] = entry->seconds >> 16;
+  out[3] = entry->seconds >> 24;
+  out[4] = entry->ms;
+  out[5] = entry->ms >> 8;
+  out[6] = entry->type;
+  out[7] = entry->arg;
+}
+
+static void prv_finish_send() {
+  free(s_sending);
+  s_sending = NULL;
+  s_sending_count = 0;
+  s_sent = 0;
+}
+
+static void prv_send_chunk() {
+  uint8_t count = s_sending_count - s_sent;
+  if (count > TRACE_CHUNK_ENTRIES) {
+    count = TRACE_CHUNK_ENTRIES;
+  }
+  uint8_t chunk[TRACE_CHUNK_SIZE];
+  chunk[0] = TRACE_VERSION;
+  chunk[1] = s_sent;
+  chunk[2] = s_sending_count;
+  for (uint8_t i = 0; i < count; i++) {
+    prv_write_entry(&chunk[TRACE_HEADER_SIZE + i * TRACE_ENTRY_SIZE], &s_sending[s_sent + i]);
+  }
+
+  DictionaryIterator *iter;
+  if (app_message_outbox_begin(&iter) != APP_MSG_OK) {
+    LOG_WARNING("Trace: outbox busy, dropping the send");
+    prv_finish_send();
+    return;
+  }
+  dict_write_data(iter, MESSAGE_KEY_TraceData, chunk, TRACE_HEADER_SIZE + count * TRACE_ENTRY_SIZE);
+  app_message_outbox_send();
+  s_sent += count;
+}
+
+static void prv_outbox_sent(DictionaryIterator *iter, void *context) {
+  if (!s_sending) {
+    return;
+  }
+  if (s_sent < s_sending_count) {
+    prv_send_chunk();
+  } else {
+    LOG_DEBUG("Trace: sent %d entries", s_sending_count);
+    prv_finish_send();
+  }
+}
+
+static void prv_outbox_failed(DictionaryIterator *iter, AppMessageResult reason, void *context) {
+  if (s_sending) {
+    LOG_WARNING("Trace: send failed (%d)", (int)reason);
+    prv_finish_send();
+  }
+}
+
+void trace_send(void) {
+  if (s_sending || s_count == 0) {
+    return;
+  }
+  s_sending = malloc(s_count * sizeof(TraceEntry));
+  if (!s_sending) {
+    return;
+  }
+  // Oldest first: once the ring has wrapped, that is the entry at s_head
+  uint8_t oldest = (s_head + TRACE_CAPACITY - s_count) % TRACE_CAPACITY;
+  for (uint8_t i = 0; i < s_count; i++) {
+    s_sending[i] = s_entries[(oldest + i) % TRACE_CAPACITY];
+  }
+  s_sending_count = s_count;
+  s_sent = 0;
+  prv_send_chunk();
+}
+
+void trace_init(void) {
+  s_sent_handle = events_app_message_register_outbox_sent(prv_outbox_sent, NULL);
+  s_failed_handle = events_app_message_register_outbox_failed(prv_outbox_failed, NULL);
+  // One chunk, plus the dictionary header and the tuple header
+  events_app_message_request_outbox_size(1 + 7 + TRACE_CHUNK_SIZE);
+}
+
+void trace_deinit(void) {
+  events_app_message_unsubscribe(s_sent_handle);
+  events_app_message_unsubscribe(s_failed_handle);
+  if (s_sending) {
+    prv_finish_send();
+  }
+}
@@ -0,0 +1,32 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <pebble.h>
+
+// A fixed-size ring of timestamped binary events, cheap enough to leave on in
+// release builds. The phone pulls it on demand (see src/pkjs/index.js) and
+// decodes it into a timeline, for power problems that only show up in the field.
+
+#define TRACE_CAPACITY PBL_IF_COLOR_ELSE(128, 64)
+
+typedef enum {
+  TraceEventTick = 1,   // arg: the TimeUnits that changed
+  TraceEventRedrawStart,
+  TraceEventRedrawEnd,
+  TraceEventBattery,    // arg: charge percent, top bit set while charging
+  TraceEventBluetooth,  // arg: 1 if connected
+  TraceEventSettings,
+  TraceEventThemeSwap,  // arg: 1 for day
+  TraceEventSleep       // arg: 1 if asleep
+} TraceEventType;
+
+void trace_init(void);
+void trace_deinit(void);
+
+void trace_record(TraceEventType type, uint8_t arg);
+
+// Sends everything recorded so far to the phone as TraceData messages,
+// oldest first
+void trace_send(void);
+
+#endif
@@ -118,6 +118,91 @@ module.exports = [
       }
     ]
   },
+  {
+    "type": "section",
+    "items": [
+      {
+        "type": "heading",
+        "defaultValue": "Night"
+      },
+      {
+        "type": "radiogroup",
+        "messageKey": "SleepQuiet",
+        "label": "Quiet mode while you sleep?",
+        "capabilities": ["HEALTH"],
+        "defaultValue": "yes",
+        "description": "Uses Pebble Health sleep tracking. While quiet, the face only updates hourly and Bluetooth vibrations are held back.",
+        "options": [
+          {
+            "label":"Yes",
+            "value":"yes"
+          },
+          {
+            "label":"No",
+            "value":"no"
+          }
+        ]
+      },
+      {
+        "type": "radiogroup",
+        "messageKey": "QuietWindow",
+        "label": "Quiet mode at set hours?",
+        "defaultValue": "no",
+        "options": [
+          {
+            "label":"Yes",
+            "value":"yes"
+          },
+          {
+            "label":"No",
+            "value":"no"
+          }
+        ]
+      },
+      {
+        "type": "slider",
+        "messageKey": "QuietStart",
+        "defaultValue": 23,
+        "label": "Quiet starts at:",
+        "min": 0,
+        "max": 23
+      },
+      {
+        "type": "slider",
+        "messageKey": "QuietEnd",
+        "defaultValue": 7,
+        "label": "Quiet ends at:",
+        "min": 0,
+        "max": 23
+      }
+    ]
+  },
+  {
+    "type": "section",
+    "items": [
+      {
+        "type": "heading",
+        "defaultValue": "Diagnostics"
+      },
+      {
+        "type": "radiogroup",
+        "messageKey": "Diagnostics",
+        "label": "Send an event trace when saving?",
+        "defaultValue": "no",
+        "description": "The watch sends its recent ticks, redraws, battery, Bluetooth and settings events to the phone, which writes them to the app log as a timeline.",
+        "options": [
+          {
+            "label":"Yes",
+            "value":"yes"
+          },
+          {
+            "label":"No",
+            "value":"no"
+          }
+        ]
+      }
+    ]
+  },
   {
     "type": "submit",
     "defaultValue": "Save Settings"
@@ -1,3 +1,64 @@
 var Clay = require('pebble-clay');
 var clayConfig = require('./config');
-var clay = new Clay(clayConfig);
\ No newline at end of file
+var clay = new Clay(clayConfig);
+
+// Event trace from the watch (src/c/trace.c). Each TraceData message is a
+// byte array: version, index of its first entry, total entries, then 8 bytes
+// per entry: uint32 seconds, uint16 milliseconds, event type, argument, all
+// little-endian. Chunks arrive in order; the last one prints the timeline.
+var TRACE_VERSION = 1;
+var TRACE_EVENTS = [null, 'tick', 'redraw start', 'redraw end', 'battery', 'bluetooth', 'settings', 'theme swap', 'sleep'];
+var traceEntries = [];
+
+function describeTraceArg(type, arg) {
+  switch (TRACE_EVENTS[type]) {
+    case 'tick': return (arg & 1 ? 'second ' : '') + (arg & 2 ? 'minute ' : '') + (arg & 4 ? 'hour ' : '') + (arg & 8 ? 'day' : '');
+    case 'battery': return (arg & 0x7f) + '%' + (arg & 0x80 ? ' charging' : '');
+    case 'bluetooth': return arg ? 'connected' : 'disconnected';
+    case 'theme swap': return arg ? 'day' : 'night';
+    case 'sleep': return arg ? 'asleep' : 'awake';
+    default: return '';
+  }
+}
+
+function printTrace(entries) {
+  var redraws = 0;
+  var ticks = 0;
+  console.log('Watch trace: ' + entries.length + ' events');
+  for (var i = 0; i < entries.length; i++) {
+    var entry = entries[i];
+    var name = TRACE_EVENTS[entry.type] || ('event ' + entry.type);
+    var gap = i > 0 ? ((entry.time - entries[i - 1].time) / 1000).toFixed(3) : '0.000';
+    console.log(new Date(entry.time).toISOString() + ' +' + gap + 's ' + name + ' ' + describeTraceArg(entry.type, entry.arg));
+    redraws += name === 'redraw start' ? 1 : 0;
+    ticks += name === 'tick' ? 1 : 0;
+  }
+  if (entries.length > 1) {
+    var minutes = (entries[entries.length - 1].time - entries[0].time) / 60000;
+    console.log('Watch trace: ' + redraws + ' redraws and ' + ticks + ' ticks over ' + minutes.toFixed(1) + ' minutes');
+  }
+}
+
+Pebble.addEventListener('appmessage', function(e) {
+  var data = e.payload.TraceData;
+  if (!data || data[0] !== TRACE_VERSION) {
+    return;
+  }
+  var first = data[1];
+  var total = data[2];
+  if (first === 0) {
+    traceEntries = [];
+  }
+  for (var i = 3; i + 8 <= data.length; i += 8) {
+    var seconds = (data[i] | (data[i + 1] << 8) | (data[i + 2] << 16)) + data[i + 3] * 16777216;
+    traceEntries.push({
+      time: seconds * 1000 + (data[i + 4] | (data[i + 5] << 8)),
+      type: data[i + 6],
+      arg: data[i + 7]
+    });
+  }
+  if (traceEntries.length >= total) {
+    printTrace(traceEntries);
+    traceEntries = [];
+  }
+});
@@ -0,0 +1,157 @@
+#include "mock_sdk.h"
+#include "../../src/c/enamel.h"
+
+// Stands in for the generated enamel.c: settings live in a small table the
+// replay script edits, and are persisted in enamel's format on deinit.
+
+#define ENAMEL_PKEY 3000000000
+#define ENAMEL_DICT_PKEY (ENAMEL_PKEY+1)
+#define MOCK_MAX_HANDLERS 4
+
+typedef struct {
+  const char *key;
+  bool is_int;
+  char value[16];
+} MockSetting;
+
+static MockSetting s_settings[] = {
+  { "DayStart", true, "7" },
+  { "DayEnd", true, "23" },
+  { "BatteryStatus", false, "low" },
+  { "BluetoothStatus", false, "disconnected" },
+  { "BluetoothDisconnect", false, "yes" },
+  { "BluetoothConnect", false, "yes" },
+  { "SleepQuiet", false, "yes" },
+  { "QuietWindow", false, "no" },
+  { "QuietStart", true, "23" },
+  { "QuietEnd", true, "7" },
+  { "Diagnostics", false, "no" },
+};
+
+static struct {
+  EnamelSettingsReceivedHandler *handler;
+  void *context;
+} s_handlers[MOCK_MAX_HANDLERS];
+
+static bool s_config_changed;
+
+static MockSetting *prv_lookup(const char *key) {
+  for (size_t i = 0; i < ARRAY_LENGTH(s_settings); i++) {
+    if (strcmp(s_settings[i].key, key) == 0) {
+      return &s_settings[i];
+    }
+  }
+  return NULL;
+}
+
+// Every getter call the face makes goes through here and is counted
+static MockSetting *prv_find(const char *key) {
+  mock_counters.settings_reads++;
+  return prv_lookup(key);
+}
+
+void mock_enamel_set(const char *key, const char *value) {
+  MockSetting *setting = prv_lookup(key);
+  if (setting) {
+    strncpy(setting->value, value, sizeof(setting->value) - 1);
+  } else {
+    fprintf(stderr, "Unknown setting %s\n", key);
+  }
+}
+
+void mock_enamel_deliver(void) {
+  for (int i = 0; i < MOCK_MAX_HANDLERS; i++) {
+    if (s_handlers[i].handler) {
+      s_handlers[i].handler(s_handlers[i].context);
+    }
+  }
+  s_config_changed = true;
+  mock_render();
+}
+
+int32_t enamel_get_DayStart() {
+  return atoi(prv_find("DayStart")->value);
+}
+
+int32_t enamel_get_DayEnd() {
+  return atoi(prv_find("DayEnd")->value);
+}
+
+const char* enamel_get_BatteryStatus() {
+  return prv_find("BatteryStatus")->value;
+}
+
+const char* enamel_get_BluetoothStatus() {
+  return prv_find("BluetoothStatus")->value;
+}
+
+const char* enamel_get_BluetoothDisconnect() {
+  return prv_find("BluetoothDisconnect")->value;
+}
+
+const char* enamel_get_BluetoothConnect() {
+  return prv_find("BluetoothConnect")->value;
+}
+
+const char* enamel_get_SleepQuiet() {
+  return prv_find("SleepQuiet")->value;
+}
+
+const char* enamel_get_QuietWindow() {
+  return prv_find("QuietWindow")->value;
+}
+
+int32_t enamel_get_QuietStart() {
+  return atoi(prv_find("QuietStart")->value);
+}
+
+int32_t enamel_get_QuietEnd() {
+  return atoi(prv_find("QuietEnd")->value);
+}
+
+const char* enamel_get_Diagnostics() {
+  return prv_find("Diagnostics")->value;
+}
+
+void enamel_init() {
+  s_config_changed = false;
+}
+
+void enamel_deinit() {
+  if (!s_config_changed) {
+    return;
+  }
+  // Same layout as the dictionary enamel persists: a 1 byte header, then a
+  // 7 byte tuple header and the value for every key
+  uint8_t dict[PERSIST_DATA_MAX_LENGTH];
+  size_t size = 1;
+  for (size_t i = 0; i < ARRAY_LENGTH(s_settings); i++) {
+    size += 7 + (s_settings[i].is_int ? 4 : strlen(s_settings[i].value) + 1);
+  }
+  memset(dict, 0, size);
+  persist_write_int(ENAMEL_PKEY, size);
+  persist_write_data(ENAMEL_DICT_PKEY, dict, size);
+  s_config_changed = false;
+}
+
+EventHandle enamel_settings_received_subscribe(EnamelSettingsReceivedHandler *handler, void *context) {
+  for (int i = 0; i < MOCK_MAX_HANDLERS; i++) {
+    if (!s_handlers[i].handler) {
+      s_handlers[i].handler = handler;
+      s_handlers[i].context = context;
+      return &s_handlers[i];
+    }
+  }
+  return NULL;
+}
+
+void enamel_settings_received_unsubscribe(EventHandle handle) {
+  for (int i = 0; i < MOCK_MAX_HANDLERS; i++) {
+    if (&s_handlers[i] == handle) {
+      s_handlers[i].handler = NULL;
+    }
+  }
+}
+
+void events_app_message_open(void) {
+}
@@ -0,0 +1,911 @@
+#include <math.h>
+#include <stdarg.h>
+#include "mock_sdk.h"
+#include <pebble-events/pebble-events.h>
+
+// The face's allocations go through mock_malloc; the SDK's own bookkeeping does not
+#undef malloc
+#undef free
+#undef time
+#undef localtime
+
+MockCounters mock_counters;
+
+// -----------------------------------------------------
+// Heap
+
+static size_t s_heap_used;
+
+static void *prv_alloc(size_t size) {
+  mock_counters.allocations++;
+  mock_counters.heap_allocated += size;
+  s_heap_used += size;
+  return calloc(1, size);
+}
+
+// Everything ever allocated; frees are not subtracted
+size_t heap_bytes_used(void) {
+  return s_heap_used;
+}
+
+void *mock_malloc(size_t size) {
+  return prv_alloc(size);
+}
+
+void mock_free(void *ptr) {
+  free(ptr);
+}
+
+// -----------------------------------------------------
+// Clock
+
+static int64_t s_now_ms;
+static bool s_24h_style;
+
+void mock_set_time(int64_t now_ms) {
+  s_now_ms = now_ms;
+}
+
+int64_t mock_now_ms(void) {
+  return s_now_ms;
+}
+
+void mock_set_24h_style(bool is_24h) {
+  s_24h_style = is_24h;
+}
+
+time_t mock_time(time_t *tloc) {
+  time_t now = (time_t)(s_now_ms / 1000);
+  if (tloc) {
+    *tloc = now;
+  }
+  return now;
+}
+
+struct tm *mock_localtime(const time_t *timep) {
+  static struct tm s_tm;
+  return gmtime_r(timep, &s_tm);
+}
+
+uint16_t time_ms(time_t *tloc, uint16_t *out_ms) {
+  uint16_t ms = (uint16_t)(s_now_ms % 1000);
+  mock_time(tloc);
+  if (out_ms) {
+    *out_ms = ms;
+  }
+  return ms;
+}
+
+time_t clock_to_timestamp(int day, int hour, int minute) {
+  // Like the firmware, a time that has already passed today means tomorrow
+  time_t now = mock_time(NULL);
+  time_t stamp = now - now % 86400 + hour * 3600 + minute * 60;
+  return stamp < now ? stamp + 86400 : stamp;
+}
+
+bool clock_is_24h_style(void) {
+  return s_24h_style;
+}
+
+// -----------------------------------------------------
+// Layers and windows
+
+typedef enum {
+  LayerKindPlain,
+  LayerKindText,
+  LayerKindBitmap
+} LayerKind;
+
+struct Layer {
+  GRect frame;
+  LayerUpdateProc update_proc;
+  bool hidden;
+  LayerKind kind;
+  Layer *parent;
+  Layer *first_child;
+  Layer *next_sibling;
+};
+
+struct TextLayer {
+  Layer layer;
+  const char *text;
+  GColor text_color;
+};
+
+struct BitmapLayer {
+  Layer layer;
+  const GBitmap *bitmap;
+};
+
+struct Window {
+  Layer root;
+  WindowHandlers handlers;
+  bool loaded;
+};
+
+struct GBitmap {
+  GSize size;
+  uint16_t bytes_per_row;
+  uint8_t *data; // NULL for resource images, which are never read back
+  bool owns_data;
+};
+
+struct GFontInfo {
+  uint32_t resource_id;
+};
+
+// The firmware redraws the whole window whenever any layer in it is dirty
+static bool s_dirty;
+static Window *s_top_window;
+
+static void prv_layer_init(Layer *layer, GRect frame, LayerKind kind) {
+  layer->frame = frame;
+  layer->kind = kind;
+}
+
+// Like the firmware, a destroyed layer leaves its parent and orphans its children
+static void prv_layer_deinit(Layer *layer) {
+  layer_remove_from_parent(layer);
+  for (Layer *child = layer->first_child; child; child = child->next_sibling) {
+    child->parent = NULL;
+  }
+}
+
+Layer *layer_create(GRect frame) {
+  Layer *layer = prv_alloc(sizeof(Layer));
+  prv_layer_init(layer, frame, LayerKindPlain);
+  return layer;
+}
+
+void layer_destroy(Layer *layer) {
+  prv_layer_deinit(layer);
+  free(layer);
+}
+
+GRect layer_get_bounds(const Layer *layer) {
+  return GRect(0, 0, layer->frame.size.w, layer->frame.size.h);
+}
+
+GRect layer_get_frame(const Layer *layer) {
+  return layer->frame;
+}
+
+void layer_set_frame(Layer *layer, GRect frame) {
+  layer->frame = frame;
+  s_dirty = true;
+}
+
+void layer_mark_dirty(Layer *layer) {
+  s_dirty = true;
+}
+
+void layer_set_update_proc(Layer *layer, LayerUpdateProc update_proc) {
+  layer->update_proc = update_proc;
+}
+
+void layer_add_child(Layer *parent, Layer *child) {
+  Layer **link = &parent->first_child;
+  while (*link) {
+    link = &(*link)->next_sibling;
+  }
+  *link = child;
+  child->parent = parent;
+  s_dirty = true;
+}
+
+void layer_insert_below_sibling(Layer *layer, Layer *below_sibling) {
+  Layer **link = &below_sibling->parent->first_child;
+  while (*link != below_sibling) {
+    link = &(*link)->next_sibling;
+  }
+  layer->next_sibling = below_sibling;
+  layer->parent = below_sibling->parent;
+  *link = layer;
+  s_dirty = true;
+}
+
+void layer_remove_from_parent(Layer *child) {
+  if (!child->parent) {
+    return;
+  }
+  Layer **link = &child->parent->first_child;
+  while (*link != child) {
+    link = &(*link)->next_sibling;
+  }
+  *link = child->next_sibling;
+  child->next_sibling = NULL;
+  child->parent = NULL;
+  s_dirty = true;
+}
+
+void layer_set_hidden(Layer *layer, bool hidden) {
+  if (layer->hidden != hidden) {
+    layer->hidden = hidden;
+    s_dirty = true;
+  }
+}
+
+bool layer_get_hidden(const Layer *layer) {
+  return layer->hidden;
+}
+
+TextLayer *text_layer_create(GRect frame) {
+  TextLayer *text_layer = prv_alloc(sizeof(TextLayer));
+  prv_layer_init(&text_layer->layer, frame, LayerKindText);
+  text_layer->text_color = GColorBlack;
+  return text_layer;
+}
+
+void text_layer_destroy(TextLayer *text_layer) {
+  prv_layer_deinit(&text_layer->layer);
+  free(text_layer);
+}
+
+Layer *text_layer_get_layer(TextLayer *text_layer) {
+  return &text_layer->layer;
+}
+
+void text_layer_set_text(TextLayer *text_layer, const char *text) {
+  text_layer->text = text;
+  s_dirty = true;
+}
+
+void text_layer_set_text_color(TextLayer *text_layer, GColor color) {
+  text_layer->text_color = color;
+  s_dirty = true;
+}
+
+void text_layer_set_background_color(TextLayer *text_layer, GColor color) {
+  s_dirty = true;
+}
+
+void text_layer_set_font(TextLayer *text_layer, GFont font) {
+  s_dirty = true;
+}
+
+void text_layer_set_text_alignment(TextLayer *text_layer, GTextAlignment alignment) {
+  s_dirty = true;
+}
+
+BitmapLayer *bitmap_layer_create(GRect frame) {
+  BitmapLayer *bitmap_layer = prv_alloc(sizeof(BitmapLayer));
+  prv_layer_init(&bitmap_layer->layer, frame, LayerKindBitmap);
+  return bitmap_layer;
+}
+
+void bitmap_layer_destroy(BitmapLayer *bitmap_layer) {
+  prv_layer_deinit(&bitmap_layer->layer);
+  free(bitmap_layer);
+}
+
+Layer *bitmap_layer_get_layer(const BitmapLayer *bitmap_layer) {
+  return (Layer *)&bitmap_layer->layer;
+}
+
+void bitmap_layer_set_bitmap(BitmapLayer *bitmap_layer, const GBitmap *bitmap) {
+  bitmap_layer->bitmap = bitmap;
+  s_dirty = true;
+}
+
+Window *window_create(void) {
+  Window *window = prv_alloc(sizeof(Window));
+  prv_layer_init(&window->root, GRect(0, 0, PBL_DISPLAY_WIDTH, PBL_DISPLAY_HEIGHT), LayerKindPlain);
+  return window;
+}
+
+void window_destroy(Window *window) {
+  if (window->loaded && window->handlers.unload) {
+    window->handlers.unload(window);
+  }
+  if (s_top_window == window) {
+    s_top_window = NULL;
+  }
+  free(window);
+}
+
+void window_set_window_handlers(Window *window, WindowHandlers handlers) {
+  window->handlers = handlers;
+}
+
+Layer *window_get_root_layer(const Window *window) {
+  return (Layer *)&window->root;
+}
+
+void window_stack_push(Window *window, bool animated) {
+  s_top_window = window;
+  if (!window->loaded && window->handlers.load) {
+    window->handlers.load(window);
+  }
+  window->loaded = true;
+  s_dirty = true;
+}
+
+// -----------------------------------------------------
+// Bitmaps, fonts and resources
+
+GBitmap *gbitmap_create_with_resource(uint32_t resource_id) {
+  GBitmap *bitmap = prv_alloc(sizeof(GBitmap));
+  bitmap->size = GSize(25, 25);
+  return bitmap;
+}
+
+// Every bitmap the face creates is 8 bit, like the color platforms
+GBitmap *gbitmap_create_blank(GSize size, GBitmapFormat format) {
+  GBitmap *bitmap = prv_alloc(sizeof(GBitmap));
+  bitmap->size = size;
+  bitmap->bytes_per_row = size.w;
+  bitmap->data = prv_alloc(size.w * size.h);
+  bitmap->owns_data = true;
+  return bitmap;
+}
+
+GBitmap *gbitmap_create_as_sub_bitmap(const GBitmap *base_bitmap, GRect sub_rect) {
+  GBitmap *bitmap = prv_alloc(sizeof(GBitmap));
+  bitmap->size = sub_rect.size;
+  bitmap->bytes_per_row = base_bitmap->bytes_per_row;
+  bitmap->data = base_bitmap->data + sub_rect.origin.y * base_bitmap->bytes_per_row + sub_rect.origin.x;
+  return bitmap;
+}
+
+void gbitmap_destroy(GBitmap *bitmap) {
+  if (bitmap->owns_data) {
+    free(bitmap->data);
+  }
+  free(bitmap);
+}
+
+uint16_t gbitmap_get_bytes_per_row(const GBitmap *bitmap) {
+  return bitmap->bytes_per_row;
+}
+
+GBitmapDataRowInfo gbitmap_get_data_row_info(const GBitmap *bitmap, uint16_t y) {
+  return (GBitmapDataRowInfo) {
+    .data = bitmap->data + y * bitmap->bytes_per_row,
+    .min_x = 0,
+    .max_x = bitmap->size.w - 1
+  };
+}
+
+GRect gbitmap_get_bounds(const GBitmap *bitmap) {
+  return GRect(0, 0, bitmap->size.w, bitmap->size.h);
+}
+
+void gdraw_command_image_destroy(GDrawCommandImage *image) {
+}
+
+ResHandle resource_get_handle(uint32_t resource_id) {
+  return (ResHandle)(uintptr_t)resource_id;
+}
+
+GFont fonts_load_custom_font(ResHandle handle) {
+  GFont font = prv_alloc(sizeof(struct GFontInfo));
+  font->resource_id = (uint32_t)(uintptr_t)handle;
+  return font;
+}
+
+void fonts_unload_custom_font(GFont font) {
+  free(font);
+}
+
+// -----------------------------------------------------
+// Drawing; every call that would touch the frame buffer counts once. Filled
+// rectangles, text and in-memory bitmaps also write real pixels, so the cost
+// of rasterizing text can be weighed against blitting it, and glyphs read
+// back from the frame buffer look like the firmware's.
+
+static uint8_t s_frame_buffer_data[PBL_DISPLAY_WIDTH * PBL_DISPLAY_HEIGHT];
+static GBitmap s_frame_buffer = {
+  .size = { PBL_DISPLAY_WIDTH, PBL_DISPLAY_HEIGHT },
+  .bytes_per_row = PBL_DISPLAY_WIDTH,
+  .data = s_frame_buffer_data
+};
+
+static GColor s_fill_color;
+static GColor s_text_color;
+static GCompOp s_compositing;
+
+// Blends src over dst with coverage 0-3, the way 2-bit alpha blends on the watch
+static uint8_t prv_blend(uint8_t dst, GColor src, int coverage) {
+  GColor out = { .argb = dst };
+  out.r = (src.r * coverage + out.r * (3 - coverage) + 1) / 3;
+  out.g = (src.g * coverage + out.g * (3 - coverage) + 1) / 3;
+  out.b = (src.b * coverage + out.b * (3 - coverage) + 1) / 3;
+  out.a = 3;
+  return out.argb;
+}
+
+static bool prv_clip(GRect *rect) {
+  int16_t x0 = rect->origin.x < 0 ? 0 : rect->origin.x;
+  int16_t y0 = rect->origin.y < 0 ? 0 : rect->origin.y;
+  int16_t x1 = rect->origin.x + rect->size.w;
+  int16_t y1 = rect->origin.y + rect->size.h;
+  x1 = x1 > PBL_DISPLAY_WIDTH ? PBL_DISPLAY_WIDTH : x1;
+  y1 = y1 > PBL_DISPLAY_HEIGHT ? PBL_DISPLAY_HEIGHT : y1;
+  *rect = GRect(x0, y0, x1 - x0, y1 - y0);
+  return rect->size.w > 0 && rect->size.h > 0;
+}
+
+// Stands in for the firmware's glyph rasterizer: every character is a 16x40
+// ring, anti-aliased over two pixels at its edges
+static void prv_draw_text_pixels(const char *text, GRect box, GTextAlignment alignment, GColor color) {
+  int16_t width = strlen(text) * 16;
+  int16_t x = box.origin.x;
+  if (alignment == GTextAlignmentRight) {
+    x += box.size.w - width;
+  } else if (alignment == GTextAlignmentCenter) {
+    x += (box.size.w - width) / 2;
+  }
+  int16_t height = box.size.h < 40 ? box.size.h : 40;
+  for (const char *c = text; *c; c++, x += 16) {
+    GRect glyph = GRect(x, box.origin.y, 16, height);
+    if (!prv_clip(&glyph)) {
+      continue;
+    }
+    for (int16_t py = glyph.origin.y; py < glyph.origin.y + glyph.size.h; py++) {
+      for (int16_t px = glyph.origin.x; px < glyph.origin.x + glyph.size.w; px++) {
+        int dx = 2 * (px - x) - 15, dy = (2 * (py - box.origin.y) - 39) * 16 / 40;
+        int distance = abs(dx * dx + dy * dy - 144) / 16; // 0 on the ring, growing away from it
+        int coverage = distance < 2 ? 3 : 5 - distance;
+        if (coverage > 0) {
+          uint8_t *pixel = &s_frame_buffer_data[py * PBL_DISPLAY_WIDTH + px];
+          *pixel = prv_blend(*pixel, color, coverage > 3 ? 3 : coverage);
+        }
+      }
+    }
+  }
+}
+
+void graphics_context_set_stroke_color(GContext *ctx, GColor color) {
+}
+
+void graphics_context_set_fill_color(GContext *ctx, GColor color) {
+  s_fill_color = color;
+}
+
+void graphics_context_set_text_color(GContext *ctx, GColor color) {
+  s_text_color = color;
+}
+
+void graphics_context_set_compositing_mode(GContext *ctx, GCompOp mode) {
+  s_compositing = mode;
+}
+
+void graphics_context_set_stroke_width(GContext *ctx, uint8_t stroke_width) {
+}
+
+void graphics_draw_rect(GContext *ctx, GRect rect) {
+  mock_counters.draw_calls++;
+}
+
+void graphics_fill_rect(GContext *ctx, GRect rect, uint16_t corner_radius, GCornerMask corner_mask) {
+  mock_counters.draw_calls++;
+  if (prv_clip(&rect)) {
+    for (int16_t y = rect.origin.y; y < rect.origin.y + rect.size.h; y++) {
+      memset(&s_frame_buffer_data[y * PBL_DISPLAY_WIDTH + rect.origin.x], s_fill_color.argb, rect.size.w);
+    }
+  }
+}
+
+void graphics_draw_circle(GContext *ctx, GPoint p, uint16_t radius) {
+  mock_counters.draw_calls++;
+}
+
+void graphics_fill_circle(GContext *ctx, GPoint p, uint16_t radius) {
+  mock_counters.draw_calls++;
+}
+
+void graphics_fill_radial(GContext *ctx, GRect rect, GOvalScaleMode scale_mode, uint16_t inset_thickness,
+                          int32_t angle_start, int32_t angle_end) {
+  mock_counters.draw_calls++;
+}
+
+void graphics_draw_bitmap_in_rect(GContext *ctx, const GBitmap *bitmap, GRect rect) {
+  mock_counters.draw_calls++;
+  GRect clipped = rect;
+  if (!bitmap->data || !prv_clip(&clipped)) {
+    return; // resource images carry no pixels
+  }
+  for (int16_t y = clipped.origin.y; y < clipped.origin.y + clipped.size.h && y - rect.origin.y < bitmap->size.h; y++) {
+    const uint8_t *src = bitmap->data + (y - rect.origin.y) * bitmap->bytes_per_row;
+    uint8_t *dst = &s_frame_buffer_data[y * PBL_DISPLAY_WIDTH];
+    for (int16_t x = clipped.origin.x; x < clipped.origin.x + clipped.size.w && x - rect.origin.x < bitmap->size.w; x++) {
+      GColor pixel = { .argb = src[x - rect.origin.x] };
+      if (s_compositing != GCompOpSet || pixel.a == 3) {
+        dst[x] = pixel.argb;
+      } else if (pixel.a) {
+        dst[x] = prv_blend(dst[x], pixel, pixel.a);
+      }
+    }
+  }
+}
+
+void graphics_draw_text(GContext *ctx, const char *text, GFont font, GRect box, GTextOverflowMode overflow_mode,
+                        GTextAlignment alignment, void *text_attributes) {
+  mock_counters.draw_calls++;
+  mock_counters.text_draws++;
+  prv_draw_text_pixels(text, box, alignment, s_text_color);
+}
+
+GSize graphics_text_layout_get_content_size(const char *text, GFont font, GRect box,
+                                            GTextOverflowMode overflow_mode, GTextAlignment alignment) {
+  // Roughly the time font: 16 pixels per character, 40 pixels a line
+  return GSize(strlen(text) * 16, box.size.h < 40 ? box.size.h : 40);
+}
+
+GBitmap *graphics_capture_frame_buffer(GContext *ctx) {
+  return &s_frame_buffer;
+}
+
+bool graphics_release_frame_buffer(GContext *ctx, GBitmap *buffer) {
+  return true;
+}
+
+GPath *gpath_create(const GPathInfo *init) {
+  GPath *path = prv_alloc(sizeof(GPath));
+  path->num_points = init->num_points;
+  path->points = init->points;
+  return path;
+}
+
+void gpath_destroy(GPath *path) {
+  free(path);
+}
+
+void gpath_move_to(GPath *path, GPoint point) {
+  path->offset = point;
+}
+
+void gpath_draw_filled(GContext *ctx, GPath *path) {
+  mock_counters.draw_calls++;
+}
+
+void gpath_draw_outline(GContext *ctx, GPath *path) {
+  mock_counters.draw_calls++;
+}
+
+void gpath_draw_outline_open(GContext *ctx, GPath *path) {
+  mock_counters.draw_calls++;
+}
+
+GPoint gpoint_from_polar(GRect rect, GOvalScaleMode scale_mode, int32_t angle) {
+  // Angle 0 is twelve o'clock and angles grow clockwise
+  double radians = angle * 2.0 * M_PI / TRIG_MAX_ANGLE;
+  double radius = (rect.size.w < rect.size.h ? rect.size.w : rect.size.h) / 2.0;
+  return GPoint(rect.origin.x + rect.size.w / 2 + (int16_t)lround(radius * sin(radians)),
+                rect.origin.y + rect.size.h / 2 - (int16_t)lround(radius * cos(radians)));
+}
+
+static void prv_render_layer(Layer *layer, GContext *ctx) {
+  if (layer->hidden) {
+    return;
+  }
+  if (layer->update_proc) {
+    layer->update_proc(layer, ctx);
+  } else if (layer->kind == LayerKindText && ((TextLayer *)layer)->text && ((TextLayer *)layer)->text[0]) {
+    TextLayer *text_layer = (TextLayer *)layer;
+    mock_counters.draw_calls++;
+    mock_counters.text_draws++;
+    prv_draw_text_pixels(text_layer->text, layer->frame, GTextAlignmentLeft, text_layer->text_color);
+  } else if (layer->kind == LayerKindBitmap && ((BitmapLayer *)layer)->bitmap) {
+    mock_counters.draw_calls++;
+  }
+  for (Layer *child = layer->first_child; child; child = child->next_sibling) {
+    prv_render_layer(child, ctx);
+  }
+}
+
+double mock_render_seconds;
+
+void mock_render(void) {
+  if (!s_dirty || !s_top_window) {
+    return;
+  }
+  s_dirty = false;
+  mock_counters.redraws++;
+  clock_t started = clock();
+  prv_render_layer(&s_top_window->root, NULL);
+  mock_render_seconds += (double)(clock() - started) / CLOCKS_PER_SEC;
+}
+
+// -----------------------------------------------------
+// Services and the event loop
+
+static TimeUnits s_tick_units;
+static TickHandler s_tick_handler;
+static BatteryStateHandler s_battery_handler;
+static BatteryChargeState s_battery_state = { .charge_percent = 100 };
+static ConnectionHandlers s_connection_handlers;
+static bool s_connected = true;
+
+void tick_timer_service_subscribe(TimeUnits tick_units, TickHandler handler) {
+  s_tick_units = tick_units;
+  s_tick_handler = handler;
+}
+
+void tick_timer_service_unsubscribe(void) {
+  s_tick_handler = NULL;
+}
+
+void battery_state_service_subscribe(BatteryStateHandler handler) {
+  s_battery_handler = handler;
+}
+
+BatteryChargeState battery_state_service_peek(void) {
+  return s_battery_state;
+}
+
+void connection_service_subscribe(ConnectionHandlers handlers) {
+  s_connection_handlers = handlers;
+}
+
+bool connection_service_peek_pebble_app_connection(void) {
+  return s_connected;
+}
+
+void mock_emit_battery(BatteryChargeState state) {
+  s_battery_state = state;
+  if (s_battery_handler) {
+    s_battery_handler(state);
+  }
+  mock_render();
+}
+
+void mock_emit_connection(bool connected) {
+  s_connected = connected;
+  if (s_connection_handlers.pebble_app_connection_handler) {
+    s_connection_handlers.pebble_app_connection_handler(connected);
+  }
+  mock_render();
+}
+
+static HealthEventHandler s_health_handler;
+static void *s_health_context;
+static HealthActivityMask s_activities;
+
+bool health_service_events_subscribe(HealthEventHandler handler, void *context) {
+  s_health_handler = handler;
+  s_health_context = context;
+  return true;
+}
+
+HealthActivityMask health_service_peek_current_activities(void) {
+  return s_activities;
+}
+
+void mock_emit_sleep(bool asleep) {
+  s_activities = asleep ? HealthActivitySleep : HealthActivityNone;
+  if (s_health_handler) {
+    s_health_handler(HealthEventSleepUpdate, s_health_context);
+  }
+  mock_render();
+}
+
+void vibes_enqueue_custom_pattern(VibePattern pattern) {
+  // Even segments vibrate, odd segments are pauses
+  for (uint32_t i = 0; i < pattern.num_segments; i += 2) {
+    mock_counters.vibe_ms += pattern.durations[i];
+  }
+}
+
+#define MOCK_MAX_TIMERS 16
+
+struct AppTimer {
+  int64_t due_ms;
+  AppTimerCallback callback;
+  void *data;
+  bool active;
+};
+
+static AppTimer s_timers[MOCK_MAX_TIMERS];
+
+AppTimer *app_timer_register(uint32_t timeout_ms, AppTimerCallback callback, void *callback_data) {
+  for (int i = 0; i < MOCK_MAX_TIMERS; i++) {
+    if (!s_timers[i].active) {
+      mock_counters.allocations++;
+      s_timers[i] = (AppTimer) { s_now_ms + timeout_ms, callback, callback_data, true };
+      return &s_timers[i];
+    }
+  }
+  return NULL;
+}
+
+void app_timer_cancel(AppTimer *timer_handle) {
+  if (timer_handle) {
+    timer_handle->active = false;
+  }
+}
+
+void app_event_loop(void) {
+}
+
+// One message in flight at a time, like the firmware; the sent callback comes
+// back on a later turn of the event loop
+
+static AppMessageOutboxSent s_outbox_sent;
+static void *s_outbox_sent_context;
+static bool s_outbox_open, s_outbox_in_flight;
+
+struct DictionaryIterator {
+  size_t size;
+};
+
+static DictionaryIterator s_outbox;
+
+void events_app_message_request_outbox_size(uint32_t size) {
+}
+
+EventHandle events_app_message_register_outbox_sent(AppMessageOutboxSent sent_callback, void *context) {
+  s_outbox_sent = sent_callback;
+  s_outbox_sent_context = context;
+  return &s_outbox_sent;
+}
+
+EventHandle events_app_message_register_outbox_failed(AppMessageOutboxFailed failed_callback, void *context) {
+  return &s_outbox;
+}
+
+void events_app_message_unsubscribe(EventHandle handle) {
+  if (handle == &s_outbox_sent) {
+    s_outbox_sent = NULL;
+  }
+}
+
+AppMessageResult app_message_outbox_begin(DictionaryIterator **iterator) {
+  if (s_outbox_open || s_outbox_in_flight) {
+    return APP_MSG_BUSY;
+  }
+  s_outbox_open = true;
+  s_outbox.size = 1;
+  *iterator = &s_outbox;
+  return APP_MSG_OK;
+}
+
+DictionaryResult dict_write_data(DictionaryIterator *iter, const uint32_t key, const uint8_t *data, const uint16_t size) {
+  iter->size += 7 + size;
+  return DICT_OK;
+}
+
+AppMessageResult app_message_outbox_send(void) {
+  s_outbox_open = false;
+  s_outbox_in_flight = true;
+  mock_counters.bytes_sent += s_outbox.size;
+  return APP_MSG_OK;
+}
+
+static int64_t prv_next_tick_ms(void) {
+  if (!s_tick_handler) {
+    return INT64_MAX;
+  }
+  int64_t period = (s_tick_units & SECOND_UNIT) ? 1000 :
+                   (s_tick_units & MINUTE_UNIT) ? 60 * 1000 :
+                   (s_tick_units & HOUR_UNIT) ? 3600 * 1000 : 86400 * 1000;
+  return (s_now_ms / period + 1) * period;
+}
+
+static TimeUnits prv_units_changed(time_t before, time_t after) {
+  struct tm a, b;
+  gmtime_r(&before, &a);
+  gmtime_r(&after, &b);
+  TimeUnits units = SECOND_UNIT;
+  if (a.tm_min != b.tm_min || after - before >= 60) units |= MINUTE_UNIT;
+  if (a.tm_hour != b.tm_hour || after - before >= 3600) units |= HOUR_UNIT;
+  if (a.tm_yday != b.tm_yday) units |= DAY_UNIT;
+  if (a.tm_mon != b.tm_mon) units |= MONTH_UNIT;
+  if (a.tm_year != b.tm_year) units |= YEAR_UNIT;
+  return units;
+}
+
+void mock_run_until(int64_t target_ms) {
+  for (;;) {
+    if (s_outbox_in_flight) {
+      s_outbox_in_flight = false;
+      if (s_outbox_sent) {
+        s_outbox_sent(&s_outbox, s_outbox_sent_context);
+      }
+      mock_render();
+      continue;
+    }
+
+    AppTimer *timer = NULL;
+    for (int i = 0; i < MOCK_MAX_TIMERS; i++) {
+      if (s_timers[i].active && (!timer || s_timers[i].due_ms < timer->due_ms)) {
+        timer = &s_timers[i];
+      }
+    }
+    int64_t next_tick = prv_next_tick_ms();
+
+    if (timer && timer->due_ms <= next_tick && timer->due_ms <= target_ms) {
+      s_now_ms = timer->due_ms > s_now_ms ? timer->due_ms : s_now_ms;
+      timer->active = false;
+      timer->callback(timer->data);
+    } else if (next_tick <= target_ms) {
+      time_t before = mock_time(NULL);
+      s_now_ms = next_tick;
+      time_t after = mock_time(NULL);
+      TimeUnits units = prv_units_changed(before, after);
+      if (units & s_tick_units) {
+        s_tick_handler(mock_localtime(&after), units);
+      }
+    } else {
+      break;
+    }
+    mock_render();
+  }
+  s_now_ms = target_ms;
+}
+
+// -----------------------------------------------------
+// Persistent storage
+
+#define MOCK_MAX_PERSIST_KEYS 32
+
+static struct {
+  uint32_t key;
+  size_t size;
+  uint8_t data[PERSIST_DATA_MAX_LENGTH];
+} s_persist[MOCK_MAX_PERSIST_KEYS];
+static int s_persist_count;
+
+static int prv_persist_find(uint32_t key) {
+  for (int i = 0; i < s_persist_count; i++) {
+    if (s_persist[i].key == key) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+bool persist_exists(const uint32_t key) {
+  return prv_persist_find(key) >= 0;
+}
+
+int persist_write_data(const uint32_t key, const void *data, const size_t size) {
+  int index = prv_persist_find(key);
+  if (index < 0) {
+    if (s_persist_count == MOCK_MAX_PERSIST_KEYS) {
+      return -1;
+    }
+    index = s_persist_count++;
+    s_persist[index].key = key;
+  }
+  size_t written = size < PERSIST_DATA_MAX_LENGTH ? size : PERSIST_DATA_MAX_LENGTH;
+  memcpy(s_persist[index].data, data, written);
+  s_persist[index].size = written;
+  mock_counters.bytes_persisted += written;
+  return written;
+}
+
+int persist_read_data(const uint32_t key, void *buffer, const size_t buffer_size) {
+  int index = prv_persist_find(key);
+  if (index < 0) {
+    return -1;
+  }
+  size_t read = s_persist[index].size < buffer_size ? s_persist[index].size : buffer_size;
+  memcpy(buffer, s_persist[index].data, read);
+  return read;
+}
+
+int persist_write_int(const uint32_t key, const int32_t value) {
+  return persist_write_data(key, &value, sizeof(value));
+}
+
+int32_t persist_read_int(const uint32_t key) {
+  int32_t value = 0;
+  persist_read_data(key, &value, sizeof(value));
+  return value;
+}
+
+// -----------------------------------------------------
+// Logging
+
+void app_log(uint8_t log_level, const char *src_filename, int src_line_number, const char *fmt, ...) {
+  if (!getenv("DAY_REPLAY_VERBOSE")) {
+    return;
+  }
+  va_list args;
+  va_start(args, fmt);
+  fprintf(stderr, "[%s:%d] ", src_filename, src_line_number);
+  vfprintf(stderr, fmt, args);
+  fputc('\n', stderr);
+  va_end(args);
+}
@@ -0,0 +1,48 @@
+#ifndef MOCK_SDK_H
+#define MOCK_SDK_H
+
+#include <pebble.h>
+
+// Driver side of the mocked SDK: a simulated clock, an event loop that fires
+// ticks and timers in order, and the counters the replay reports.
+
+typedef struct {
+  long redraws;
+  long draw_calls;
+  long allocations;
+  long bytes_persisted;
+  long vibe_ms;
+  long bytes_sent;
+  long text_draws;
+  long heap_allocated;
+  long settings_reads;
+  long startup_redraws;
+} MockCounters;
+
+extern MockCounters mock_counters;
+
+// Host CPU time spent drawing frames; too noisy for the baseline, so reported
+// alongside it
+extern double mock_render_seconds;
+
+void mock_set_time(int64_t now_ms);
+int64_t mock_now_ms(void);
+void mock_set_24h_style(bool is_24h);
+
+// Runs ticks up to (and including) target_ms and timers due before it,
+// rendering after each
+void mock_run_until(int64_t target_ms);
+
+// Delivers a system event to whichever handler the face subscribed, then renders
+void mock_emit_battery(BatteryChargeState state);
+void mock_emit_connection(bool connected);
+void mock_emit_sleep(bool asleep);
+
+// Draws one frame if anything was marked dirty since the last one
+void mock_render(void);
+
+// Settings as they would arrive from the phone, e.g. "DayStart", "7"
+void mock_enamel_set(const char *key, const char *value);
+void mock_enamel_deliver(void);
+
+#endif
@@ -0,0 +1,162 @@
+// Replays a day of events through the watchface's real handlers against the
+// mocked SDK, then compares the work done with a checked-in baseline.
+//
+//   day_replay <script> <baseline> [--write-baseline]
+//
+// Script lines are "HH:MM <event> [args]", in time order:
+//   battery <percent> [charging]
+//   bt <0|1>
+//   sleep <0|1>
+//   settings <Key>=<Value> ...
+//   clock24 <0|1>
+// Ticks come from the simulated clock at whatever unit the face subscribed to.
+
+#include "mock_sdk.h"
+
+#define main arc_diem_main
+#include "../../src/c/main.c"
+#undef main
+
+// 2026-01-05 00:00:00 UTC, a Monday
+#define REPLAY_DAY_START_MS (1767571200LL * 1000)
+#define REPLAY_DAY_MS (86400LL * 1000)
+
+typedef struct {
+  const char *name;
+  long *value;
+} Metric;
+
+static Metric s_metrics[] = {
+  { "redraws", &mock_counters.redraws },
+  { "draw_calls", &mock_counters.draw_calls },
+  { "text_draws", &mock_counters.text_draws },
+  { "allocations", &mock_counters.allocations },
+  { "heap_allocated", &mock_counters.heap_allocated },
+  { "bytes_persisted", &mock_counters.bytes_persisted },
+  { "vibe_ms", &mock_counters.vibe_ms },
+  { "bytes_sent", &mock_counters.bytes_sent },
+  { "settings_reads", &mock_counters.settings_reads },
+  { "startup_redraws", &mock_counters.startup_redraws },
+};
+
+static void prv_run_event(char *line, int lineno) {
+  int hour, minute, consumed;
+  char event[16];
+  if (sscanf(line, "%d:%d %15s %n", &hour, &minute, event, &consumed) != 3) {
+    fprintf(stderr, "line %d: expected \"HH:MM event\"\n", lineno);
+    exit(2);
+  }
+  char *args = line + consumed;
+  mock_run_until(REPLAY_DAY_START_MS + (hour * 3600LL + minute * 60LL) * 1000);
+
+  if (strcmp(event, "battery") == 0) {
+    int percent = atoi(args);
+    mock_emit_battery((BatteryChargeState) {
+      .charge_percent = percent,
+      .is_charging = strstr(args, "charging") != NULL,
+      .is_plugged = strstr(args, "charging") != NULL
+    });
+  } else if (strcmp(event, "bt") == 0) {
+    mock_emit_connection(atoi(args) != 0);
+  } else if (strcmp(event, "sleep") == 0) {
+    mock_emit_sleep(atoi(args) != 0);
+  } else if (strcmp(event, "settings") == 0) {
+    for (char *pair = strtok(args, " \t\n"); pair; pair = strtok(NULL, " \t\n")) {
+      char *equals = strchr(pair, '=');
+      if (equals) {
+        *equals = '\0';
+        mock_enamel_set(pair, equals + 1);
+      }
+    }
+    mock_enamel_deliver();
+  } else if (strcmp(event, "clock24") == 0) {
+    mock_set_24h_style(atoi(args) != 0);
+  } else {
+    fprintf(stderr, "line %d: unknown event %s\n", lineno, event);
+    exit(2);
+  }
+}
+
+static long prv_read_baseline(FILE *file, const char *name) {
+  char key[32];
+  long value;
+  rewind(file);
+  while (fscanf(file, "%31s %ld", key, &value) == 2) {
+    if (strcmp(key, name) == 0) {
+      return value;
+    }
+  }
+  return -1;
+}
+
+int main(int argc, char **argv) {
+  if (argc < 3) {
+    fprintf(stderr, "usage: %s <script> <baseline> [--write-baseline]\n", argv[0]);
+    return 2;
+  }
+  bool write_baseline = argc > 3 && strcmp(argv[3], "--write-baseline") == 0;
+
+  FILE *script = fopen(argv[1], "r");
+  if (!script) {
+    perror(argv[1]);
+    return 2;
+  }
+
+  clock_t started = clock();
+  mock_set_time(REPLAY_DAY_START_MS);
+  init();
+  mock_run_until(REPLAY_DAY_START_MS);
+  mock_render();
+  double launch_ms = 1000.0 * (clock() - started) / CLOCKS_PER_SEC;
+  mock_counters.startup_redraws = mock_counters.redraws;
+
+  char line[256];
+  int lineno = 0;
+  while (fgets(line, sizeof(line), script)) {
+    lineno++;
+    if (line[0] == '#' || line[strspn(line, " \t\r\n")] == '\0') {
+      continue;
+    }
+    prv_run_event(line, lineno);
+  }
+  fclose(script);
+
+  mock_run_until(REPLAY_DAY_START_MS + REPLAY_DAY_MS);
+  deinit();
+  double elapsed = (double)(clock() - started) / CLOCKS_PER_SEC;
+
+  if (write_baseline) {
+    FILE *baseline = fopen(argv[2], "w");
+    if (!baseline) {
+      perror(argv[2]);
+      return 2;
+    }
+    for (size_t i = 0; i < ARRAY_LENGTH(s_metrics); i++) {
+      fprintf(baseline, "%s %ld\n", s_metrics[i].name, *s_metrics[i].value);
+    }
+    fclose(baseline);
+    printf("Baseline written to %s\n", argv[2]);
+    return 0;
+  }
+
+  FILE *baseline = fopen(argv[2], "r");
+  if (!baseline) {
+    perror(argv[2]);
+    return 2;
+  }
+  int regressions = 0;
+  printf("Launch to first frame in %.3fms, replayed 24h in %.3fs\n", launch_ms, elapsed);
+  printf("Drew %ld frames in %.1fms, %.1fus each\n", mock_counters.redraws, 1000.0 * mock_render_seconds,
+         1e6 * mock_render_seconds / mock_counters.redraws);
+  printf("%-16s %10s %10s %8s\n", "metric", "baseline", "replay", "change");
+  for (size_t i = 0; i < ARRAY_LENGTH(s_metrics); i++) {
+    long expected = prv_read_baseline(baseline, s_metrics[i].name);
+    long actual = *s_metrics[i].value;
+    double change = expected > 0 ? 100.0 * (actual - expected) / expected : 0.0;
+    printf("%-16s %10ld %10ld %+7.1f%%%s\n", s_metrics[i].name, expected, actual, change,
+           actual > expected ? "  REGRESSION" : "");
+    regressions += actual > expected;
+  }
+  fclose(baseline);
+  return regressions ? 1 : 0;
+}
@@ -0,0 +1,10 @@
+#!/bin/sh
+# Builds the day replay against the mocked SDK and checks it against the baseline.
+# Pass --write-baseline to record a new baseline after an intended change.
+set -e
+cd "$(dirname "$0")"
+mkdir -p build
+python3 ../geometry.py 144 168 rect > build/geometry.auto.h
+${CC:-cc} -std=gnu99 -Wall -Wno-unused-parameter -O1 -Isdk -Ibuild -I../../src/c $CFLAGS \
+  -o build/day_replay replay.c mock_sdk.c mock_enamel.c ../../src/c/display_list.c ../../src/c/complication.c ../../src/c/trace.c ../../src/c/glyph_atlas.c -lm
+./build/day_replay day.events baseline.txt "$@"
@@ -0,0 +1,6 @@
+#ifndef MOCK_PDC_TRANSFORM_H
+#define MOCK_PDC_TRANSFORM_H
+
+#include <pebble.h>
+
+#endif
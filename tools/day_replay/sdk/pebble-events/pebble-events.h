@@ -0,0 +1,14 @@
+#ifndef MOCK_PEBBLE_EVENTS_H
+#define MOCK_PEBBLE_EVENTS_H
+
+#include <pebble.h>
+
+typedef void* EventHandle;
+
+void events_app_message_open(void);
+void events_app_message_request_outbox_size(uint32_t size);
+EventHandle events_app_message_register_outbox_sent(AppMessageOutboxSent sent_callback, void *context);
+EventHandle events_app_message_register_outbox_failed(AppMessageOutboxFailed failed_callback, void *context);
+void events_app_message_unsubscribe(EventHandle handle);
+
+#endif
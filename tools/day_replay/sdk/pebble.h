@@ -0,0 +1,330 @@
+#ifndef MOCK_PEBBLE_H
+#define MOCK_PEBBLE_H
+
+// Just enough of the Pebble SDK for the watchface to compile on the host.
+// Everything the face asks of the SDK is routed through mock_sdk.c, which
+// counts it and keeps a simulated clock.
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+
+#ifndef PBL_DISPLAY_WIDTH
+#define PBL_DISPLAY_WIDTH 144
+#define PBL_DISPLAY_HEIGHT 168
+#endif
+#define PBL_COLOR
+#define PBL_RECT
+#define PBL_HEALTH
+#define PBL_IF_ROUND_ELSE(if_true, if_false) (if_false)
+#define PBL_IF_RECT_ELSE(if_true, if_false) (if_true)
+#define PBL_IF_COLOR_ELSE(if_true, if_false) (if_true)
+#define PBL_IF_BW_ELSE(if_true, if_false) (if_false)
+#define PBL_IF_HEALTH_ELSE(if_true, if_false) (if_true)
+
+#define ARRAY_LENGTH(array) (sizeof(array) / sizeof((array)[0]))
+
+// Graphics types
+
+typedef struct { int16_t x, y; } GPoint;
+typedef struct { int16_t w, h; } GSize;
+typedef struct { GPoint origin; GSize size; } GRect;
+typedef union {
+  uint8_t argb;
+  struct {
+    uint8_t b:2;
+    uint8_t g:2;
+    uint8_t r:2;
+    uint8_t a:2;
+  };
+} GColor8;
+typedef GColor8 GColor;
+
+#define GPoint(x, y) ((GPoint){(x), (y)})
+#define GSize(w, h) ((GSize){(w), (h)})
+#define GRect(x, y, w, h) ((GRect){{(x), (y)}, {(w), (h)}})
+#define GPointZero GPoint(0, 0)
+#define GSizeZero GSize(0, 0)
+#define GRectZero GRect(0, 0, 0, 0)
+#define gcolor_equal(a, b) ((a).argb == (b).argb)
+
+#define GColorClear ((GColor8){0x00})
+#define GColorBlack ((GColor8){0xC0})
+#define GColorOxfordBlue ((GColor8){0xC1})
+#define GColorKellyGreen ((GColor8){0xD4})
+#define GColorDarkCandyAppleRed ((GColor8){0xE0})
+#define GColorLightGray ((GColor8){0xEA})
+#define GColorChromeYellow ((GColor8){0xF8})
+#define GColorWhite ((GColor8){0xFF})
+
+typedef struct GContext GContext;
+typedef struct Layer Layer;
+typedef struct TextLayer TextLayer;
+typedef struct BitmapLayer BitmapLayer;
+typedef struct GBitmap GBitmap;
+typedef struct Window Window;
+typedef struct GFontInfo *GFont;
+typedef struct GDrawCommandImage GDrawCommandImage;
+typedef const void *ResHandle;
+
+typedef struct {
+  uint32_t num_points;
+  GPoint *points;
+} GPathInfo;
+
+typedef struct GPath {
+  uint32_t num_points;
+  GPoint *points;
+  int32_t rotation;
+  GPoint offset;
+} GPath;
+
+typedef enum { GOvalScaleModeFitCircle, GOvalScaleModeFillCircle } GOvalScaleMode;
+typedef enum { GCornerNone = 0 } GCornerMask;
+typedef enum { GTextAlignmentLeft, GTextAlignmentCenter, GTextAlignmentRight } GTextAlignment;
+typedef enum { GTextOverflowModeWordWrap, GTextOverflowModeTrailingEllipsis, GTextOverflowModeFill } GTextOverflowMode;
+typedef enum {
+  GBitmapFormat1Bit, GBitmapFormat8Bit, GBitmapFormat1BitPalette,
+  GBitmapFormat2BitPalette, GBitmapFormat4BitPalette, GBitmapFormat8BitCircular
+} GBitmapFormat;
+
+#define TRIG_MAX_ANGLE 0x10000
+#define DEG_TO_TRIGANGLE(angle) (((angle) * TRIG_MAX_ANGLE) / 360)
+
+// Layers and windows
+
+typedef void (*LayerUpdateProc)(Layer *layer, GContext *ctx);
+typedef void (*WindowHandler)(Window *window);
+typedef struct {
+  WindowHandler load;
+  WindowHandler appear;
+  WindowHandler disappear;
+  WindowHandler unload;
+} WindowHandlers;
+
+Layer *layer_create(GRect frame);
+void layer_destroy(Layer *layer);
+GRect layer_get_bounds(const Layer *layer);
+GRect layer_get_frame(const Layer *layer);
+void layer_set_frame(Layer *layer, GRect frame);
+void layer_mark_dirty(Layer *layer);
+void layer_set_update_proc(Layer *layer, LayerUpdateProc update_proc);
+void layer_add_child(Layer *parent, Layer *child);
+void layer_insert_below_sibling(Layer *layer, Layer *below_sibling);
+void layer_remove_from_parent(Layer *child);
+void layer_set_hidden(Layer *layer, bool hidden);
+bool layer_get_hidden(const Layer *layer);
+
+TextLayer *text_layer_create(GRect frame);
+void text_layer_destroy(TextLayer *text_layer);
+Layer *text_layer_get_layer(TextLayer *text_layer);
+void text_layer_set_text(TextLayer *text_layer, const char *text);
+void text_layer_set_text_color(TextLayer *text_layer, GColor color);
+void text_layer_set_background_color(TextLayer *text_layer, GColor color);
+void text_layer_set_font(TextLayer *text_layer, GFont font);
+void text_layer_set_text_alignment(TextLayer *text_layer, GTextAlignment alignment);
+
+BitmapLayer *bitmap_layer_create(GRect frame);
+void bitmap_layer_destroy(BitmapLayer *bitmap_layer);
+Layer *bitmap_layer_get_layer(const BitmapLayer *bitmap_layer);
+void bitmap_layer_set_bitmap(BitmapLayer *bitmap_layer, const GBitmap *bitmap);
+
+Window *window_create(void);
+void window_destroy(Window *window);
+void window_set_window_handlers(Window *window, WindowHandlers handlers);
+Layer *window_get_root_layer(const Window *window);
+void window_stack_push(Window *window, bool animated);
+
+// Bitmaps, fonts and resources
+
+GBitmap *gbitmap_create_with_resource(uint32_t resource_id);
+GBitmap *gbitmap_create_blank(GSize size, GBitmapFormat format);
+void gbitmap_destroy(GBitmap *bitmap);
+GRect gbitmap_get_bounds(const GBitmap *bitmap);
+GBitmap *gbitmap_create_as_sub_bitmap(const GBitmap *base_bitmap, GRect sub_rect);
+uint16_t gbitmap_get_bytes_per_row(const GBitmap *bitmap);
+typedef struct {
+  uint8_t *data;
+  int16_t min_x;
+  int16_t max_x;
+} GBitmapDataRowInfo;
+GBitmapDataRowInfo gbitmap_get_data_row_info(const GBitmap *bitmap, uint16_t y);
+void gdraw_command_image_destroy(GDrawCommandImage *image);
+
+ResHandle resource_get_handle(uint32_t resource_id);
+GFont fonts_load_custom_font(ResHandle handle);
+void fonts_unload_custom_font(GFont font);
+
+enum {
+  RESOURCE_ID_IMAGE_MENU_ICON = 1,
+  RESOURCE_ID_IMAGE_DAY_ON_WHITE,
+  RESOURCE_ID_IMAGE_NIGHT_ON_BLACK,
+  RESOURCE_ID_IMAGE_BATTERY_ICON,
+  RESOURCE_ID_IMAGE_BATTERY_ICON_PLUS,
+  RESOURCE_ID_IMAGE_BATTERY_ICON_DARK,
+  RESOURCE_ID_IMAGE_BATTERY_ICON_PLUS_DARK,
+  RESOURCE_ID_IMAGE_BLUETOOTH,
+  RESOURCE_ID_IMAGE_BLUETOOTH_DARK,
+  RESOURCE_ID_IMAGE_BLUETOOTH_ON,
+  RESOURCE_ID_IMAGE_BLUETOOTH_ON_DARK,
+  RESOURCE_ID_IMAGE_BLUETOOTH_OFF,
+  RESOURCE_ID_IMAGE_BLUETOOTH_OFF_DARK,
+  RESOURCE_ID_FONT_ECZAR_SEMIBOLD_LARGE_44,
+  RESOURCE_ID_FONT_ECZAR_SEMIBOLD_MEDIUM_25,
+  RESOURCE_ID_FONT_ECZAR_SEMIBOLD_32,
+  RESOURCE_ID_FONT_ECZAR_SEMIBOLD_SMALL_18
+};
+
+// Drawing
+
+void graphics_context_set_stroke_color(GContext *ctx, GColor color);
+void graphics_context_set_fill_color(GContext *ctx, GColor color);
+void graphics_context_set_text_color(GContext *ctx, GColor color);
+typedef enum { GCompOpAssign, GCompOpAssignInverted, GCompOpOr, GCompOpAnd, GCompOpClear, GCompOpSet } GCompOp;
+void graphics_context_set_compositing_mode(GContext *ctx, GCompOp mode);
+void graphics_context_set_stroke_width(GContext *ctx, uint8_t stroke_width);
+void graphics_draw_rect(GContext *ctx, GRect rect);
+void graphics_fill_rect(GContext *ctx, GRect rect, uint16_t corner_radius, GCornerMask corner_mask);
+void graphics_draw_circle(GContext *ctx, GPoint p, uint16_t radius);
+void graphics_fill_circle(GContext *ctx, GPoint p, uint16_t radius);
+void graphics_fill_radial(GContext *ctx, GRect rect, GOvalScaleMode scale_mode, uint16_t inset_thickness,
+                          int32_t angle_start, int32_t angle_end);
+void graphics_draw_bitmap_in_rect(GContext *ctx, const GBitmap *bitmap, GRect rect);
+void graphics_draw_text(GContext *ctx, const char *text, GFont font, GRect box, GTextOverflowMode overflow_mode,
+                        GTextAlignment alignment, void *text_attributes);
+GSize graphics_text_layout_get_content_size(const char *text, GFont font, GRect box,
+                                            GTextOverflowMode overflow_mode, GTextAlignment alignment);
+GBitmap *graphics_capture_frame_buffer(GContext *ctx);
+bool graphics_release_frame_buffer(GContext *ctx, GBitmap *buffer);
+
+GPath *gpath_create(const GPathInfo *init);
+void gpath_destroy(GPath *path);
+void gpath_move_to(GPath *path, GPoint point);
+void gpath_draw_filled(GContext *ctx, GPath *path);
+void gpath_draw_outline(GContext *ctx, GPath *path);
+void gpath_draw_outline_open(GContext *ctx, GPath *path);
+GPoint gpoint_from_polar(GRect rect, GOvalScaleMode scale_mode, int32_t angle);
+
+// Services
+
+typedef enum {
+  SECOND_UNIT = 1 << 0,
+  MINUTE_UNIT = 1 << 1,
+  HOUR_UNIT = 1 << 2,
+  DAY_UNIT = 1 << 3,
+  MONTH_UNIT = 1 << 4,
+  YEAR_UNIT = 1 << 5
+} TimeUnits;
+
+typedef struct {
+  uint8_t charge_percent;
+  bool is_charging;
+  bool is_plugged;
+} BatteryChargeState;
+
+typedef void (*TickHandler)(struct tm *tick_time, TimeUnits units_changed);
+typedef void (*BatteryStateHandler)(BatteryChargeState charge);
+typedef void (*ConnectionHandler)(bool connected);
+typedef struct {
+  ConnectionHandler pebble_app_connection_handler;
+  ConnectionHandler pebblekit_connection_handler;
+} ConnectionHandlers;
+
+void tick_timer_service_subscribe(TimeUnits tick_units, TickHandler handler);
+void tick_timer_service_unsubscribe(void);
+void battery_state_service_subscribe(BatteryStateHandler handler);
+BatteryChargeState battery_state_service_peek(void);
+void connection_service_subscribe(ConnectionHandlers handlers);
+bool connection_service_peek_pebble_app_connection(void);
+
+typedef enum {
+  HealthEventSignificantUpdate = 0,
+  HealthEventMovementUpdate,
+  HealthEventSleepUpdate,
+  HealthEventMetricAlert,
+  HealthEventHeartRateUpdate
+} HealthEventType;
+
+typedef uint32_t HealthActivityMask;
+enum {
+  HealthActivityNone = 0,
+  HealthActivitySleep = 1 << 0,
+  HealthActivityRestfulSleep = 1 << 1,
+  HealthActivityWalk = 1 << 2,
+  HealthActivityRun = 1 << 3,
+  HealthActivityOpenWorkout = 1 << 4
+};
+
+typedef void (*HealthEventHandler)(HealthEventType event, void *context);
+bool health_service_events_subscribe(HealthEventHandler handler, void *context);
+HealthActivityMask health_service_peek_current_activities(void);
+
+typedef struct {
+  const uint32_t *durations;
+  uint32_t num_segments;
+} VibePattern;
+void vibes_enqueue_custom_pattern(VibePattern pattern);
+
+typedef struct AppTimer AppTimer;
+typedef void (*AppTimerCallback)(void *data);
+AppTimer *app_timer_register(uint32_t timeout_ms, AppTimerCallback callback, void *callback_data);
+void app_timer_cancel(AppTimer *timer_handle);
+
+void app_event_loop(void);
+
+// AppMessage, just enough for the trace to send through
+
+typedef enum { APP_MSG_OK = 0, APP_MSG_BUSY = 64 } AppMessageResult;
+typedef enum { DICT_OK = 0 } DictionaryResult;
+typedef struct DictionaryIterator DictionaryIterator;
+typedef void (*AppMessageOutboxSent)(DictionaryIterator *iterator, void *context);
+typedef void (*AppMessageOutboxFailed)(DictionaryIterator *iterator, AppMessageResult reason, void *context);
+AppMessageResult app_message_outbox_begin(DictionaryIterator **iterator);
+AppMessageResult app_message_outbox_send(void);
+DictionaryResult dict_write_data(DictionaryIterator *iter, const uint32_t key, const uint8_t *data, const uint16_t size);
+
+// The SDK generates these from package.json; only the ones the face uses directly
+#define MESSAGE_KEY_TraceData 11
+
+// Persistent storage
+
+#define PERSIST_DATA_MAX_LENGTH 256
+bool persist_exists(const uint32_t key);
+int persist_write_int(const uint32_t key, const int32_t value);
+int32_t persist_read_int(const uint32_t key);
+int persist_write_data(const uint32_t key, const void *data, const size_t size);
+int persist_read_data(const uint32_t key, void *buffer, const size_t buffer_size);
+
+// Wall clock, served from the simulated time in mock_sdk.c
+
+#define TODAY 0
+time_t mock_time(time_t *tloc);
+struct tm *mock_localtime(const time_t *timep);
+uint16_t time_ms(time_t *tloc, uint16_t *out_ms);
+time_t clock_to_timestamp(int day, int hour, int minute);
+bool clock_is_24h_style(void);
+#define time(tloc) mock_time(tloc)
+#define localtime(timep) mock_localtime(timep)
+
+// Logging
+
+#define APP_LOG_LEVEL_ERROR 1
+#define APP_LOG_LEVEL_WARNING 50
+#define APP_LOG_LEVEL_INFO 100
+#define APP_LOG_LEVEL_DEBUG 200
+#define APP_LOG_LEVEL_DEBUG_VERBOSE 255
+void app_log(uint8_t log_level, const char *src_filename, int src_line_number, const char *fmt, ...);
+#define APP_LOG(level, fmt, ...) app_log(level, __FILE__, __LINE__, fmt, ##__VA_ARGS__)
+
+// Heap traffic from the face is counted as well
+size_t heap_bytes_used(void);
+void *mock_malloc(size_t size);
+void mock_free(void *ptr);
+#define malloc(size) mock_malloc(size)
+#define free(ptr) mock_free(ptr)
+
+#endif
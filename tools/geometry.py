@@ -0,0 +1,92 @@
+#!/usr/bin/env python
+#
+# Generates geometry.auto.h: the sun, moon and dial geometry for one display
+# size, scaled from the master definition below so every platform gets
+# integer-exact constants and nothing is computed at runtime.
+#
+#   python tools/geometry.py <width> <height> <rect|round> > geometry.auto.h
+#
+
+from __future__ import division, print_function
+
+import sys
+
+# Master geometry, drawn for the 200px wide display at MASTER_SCALE
+MASTER_SCALE = 7
+MASTER = {
+    'sun_inner_rays': [(7, 7), (21, 14), (35, 7), (28, 21), (35, 35), (21, 28), (7, 35), (14, 21)],
+    'sun_outer_rays': [(21, 0), (28, 14), (42, 21), (28, 28), (21, 42), (14, 28), (0, 21), (14, 14)],
+    'sun_offset': 21,
+    'small_sun_radius': 10,
+    'moon_outer_radius': 19,
+    'moon_inner_radius': 11,
+}
+
+# The dial insets are fixed in pixels rather than scaled
+DIAL_HAND_INSET = 2
+DIAL_TRIM_INSET = 12
+
+# Known displays keep the scale they were designed at; others follow their width
+DISPLAY_SCALES = {
+    (144, 168): 5,
+    (180, 180): 5,
+    (200, 228): 7,
+}
+
+
+def display_scale(width, height):
+    return DISPLAY_SCALES.get((width, height), max(1, int(min(width, height) * MASTER_SCALE / 200 + 0.5)))
+
+
+def scaled(value, scale):
+    # Round half up, the same way for every value, so the tables stay reproducible
+    return (value * scale * 2 + MASTER_SCALE) // (MASTER_SCALE * 2)
+
+
+def dial_rects(width, height, round_display):
+    if round_display:
+        center = (width // 2, height // 2)
+        hand = (DIAL_HAND_INSET, DIAL_HAND_INSET, width - 2 * DIAL_HAND_INSET, height - 2 * DIAL_HAND_INSET)
+        trim = (DIAL_TRIM_INSET, DIAL_TRIM_INSET, width - 2 * DIAL_TRIM_INSET, height - 2 * DIAL_TRIM_INSET)
+        center_line = (width // 4, width // 4, width // 2, width // 2)
+    else:
+        # The dial is a half circle resting on the bottom edge
+        top = height - width // 2
+        center = (width // 2, height)
+        hand = (DIAL_HAND_INSET, top + DIAL_HAND_INSET, width - 2 * DIAL_HAND_INSET, width - 2 * DIAL_HAND_INSET)
+        trim = (DIAL_TRIM_INSET, top + DIAL_TRIM_INSET, width - 2 * DIAL_TRIM_INSET, width - 2 * DIAL_TRIM_INSET)
+        center_line = (width // 4, height - width // 4, width // 2, width // 2)
+    return center, hand, trim, center_line
+
+
+def generate_geometry_header(width, height, round_display):
+    scale = display_scale(width, height)
+    center, hand, trim, center_line = dial_rects(width, height, round_display)
+
+    def points(name):
+        return ', '.join('{{{}, {}}}'.format(scaled(x, scale), scaled(y, scale)) for x, y in MASTER[name])
+
+    lines = [
+        '// Generated by tools/geometry.py for a {}x{} {} display. Do not edit.'.format(
+            width, height, 'round' if round_display else 'rectangular'),
+        '#pragma once',
+        '',
+        'static const GPoint SUN_INNER_RAYS[] = {{{}}};'.format(points('sun_inner_rays')),
+        'static const GPoint SUN_OUTER_RAYS[] = {{{}}};'.format(points('sun_outer_rays')),
+        '#define SUN_OFFSET {}'.format(scaled(MASTER['sun_offset'], scale)),
+        '#define SMALL_SUN_RADIUS {}'.format(scaled(MASTER['small_sun_radius'], scale)),
+        '#define MOON_OUTER_RADIUS {}'.format(scaled(MASTER['moon_outer_radius'], scale)),
+        '#define MOON_INNER_RADIUS {}'.format(scaled(MASTER['moon_inner_radius'], scale)),
+        '',
+        '#define DIAL_CENTER GPoint({}, {})'.format(*center),
+        '#define DIAL_HAND_BOUNDS GRect({}, {}, {}, {})'.format(*hand),
+        '#define DIAL_TRIM_BOUNDS GRect({}, {}, {}, {})'.format(*trim),
+        '#define DIAL_CENTER_LINE_BOUNDS GRect({}, {}, {}, {})'.format(*center_line),
+    ]
+    return '\n'.join(lines) + '\n'
+
+
+if __name__ == '__main__':
+    if len(sys.argv) != 4 or sys.argv[3] not in ('rect', 'round'):
+        sys.exit('usage: geometry.py <width> <height> <rect|round>')
+    sys.stdout.write(generate_geometry_header(int(sys.argv[1]), int(sys.argv[2]), sys.argv[3] == 'round'))